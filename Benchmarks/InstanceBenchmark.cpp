@@ -0,0 +1,278 @@
+// Multi-instance scaling and startup benchmark.
+//
+// Instantiates N VizBeatsAudioProcessor objects the way a large template does, prepares
+// them, and runs processBlock round-robin over all of them for a number of audio cycles.
+// Reports construction and prepare time, createEditor time and time to first frame (with
+// --editors), resident memory per instance and CPU per audio cycle. --lanes=N gives every
+// instance N polyrhythm lanes (up to 8) on top of the main beat. The shared columns count the
+// click tables and glyph caches alive across all N instances, which stay at one per sample
+// rate / font size however many instances there are.
+//
+//   VizBeatsInstanceBench [--counts=1,10,100,500] [--editors] [--lanes=N] [--cycles=N]
+//                         [--block-size=N] [--sample-rate=Hz] [--csv=path]
+//
+// Editors are never put on the desktop (the benchmark runs without a display); the first
+// frame is the editor painted into an offscreen image, which builds its visualizer caches.
+// Resident memory comes from /proc/self/statm and is only reported on Linux.
+
+#include <JuceHeader.h>
+
+#include "../Source/FrameProfiler.h"
+#include "../Source/GlyphCache.h"
+#include "../Source/PluginProcessor.h"
+
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+namespace
+{
+struct BenchConfig
+{
+  bool withEditors = false;
+  int lanes = 0;
+  int cycles = 2000;
+  int blockSize = 512;
+  double sampleRate = 48000.0;
+};
+
+struct BenchResult
+{
+  int count = 0;
+  double constructMsPerInstance = 0.0;
+  double prepareMsPerInstance = 0.0;
+  double createEditorMsPerInstance = 0.0;
+  double firstFrameMsPerInstance = 0.0;
+  double residentKbPerInstance = -1.0; // -1 = not available on this platform
+  double cycleMeanMs = 0.0;
+  double cycleP99Ms = 0.0;
+  double cycleCpuMs = 0.0;
+  double cycleLoadPercent = 0.0; // CPU per cycle relative to the block's real-time duration
+  size_t sharedClickTables = 0;
+  size_t sharedGlyphCaches = 0;
+};
+
+double getNowSeconds()
+{
+  return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks());
+}
+
+double getProcessCpuSeconds()
+{
+  return static_cast<double>(std::clock()) / static_cast<double>(CLOCKS_PER_SEC);
+}
+
+// Resident set size in KiB, or -1 where it can't be read.
+double getResidentKb()
+{
+#if JUCE_LINUX
+  const auto fields = juce::StringArray::fromTokens(juce::File("/proc/self/statm").loadFileAsString(), true);
+  if (fields.size() < 2)
+    return -1.0;
+
+  return static_cast<double>(fields[1].getLargeIntValue()) * static_cast<double>(sysconf(_SC_PAGESIZE)) / 1024.0;
+#else
+  return -1.0;
+#endif
+}
+
+void setParameter(VizBeatsAudioProcessor& processor, const char* paramId, float value)
+{
+  if (auto* param = processor.apvts.getParameter(paramId))
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+// Odd pulse counts (3, 5, 7, ...) so lanes rarely click on the same sample.
+PolyrhythmLanes makeBenchLanes(int count)
+{
+  PolyrhythmLanes lanes;
+  for (int i = 0; i < juce::jmin(count, PolyrhythmLanes::maxLanes); ++i)
+  {
+    auto& lane = lanes.lanes[static_cast<size_t>(i)];
+    lane.pulses = 3 + 2 * i;
+    lane.accents = 1u;
+    lane.voice = i % ClickTables::numLaneVoices;
+  }
+
+  return lanes;
+}
+
+BenchResult runCount(int count, const BenchConfig& config)
+{
+  BenchResult result;
+  result.count = count;
+
+  const auto residentBefore = getResidentKb();
+
+  std::vector<std::unique_ptr<VizBeatsAudioProcessor>> processors;
+  processors.reserve(static_cast<size_t>(count));
+
+  auto start = getNowSeconds();
+  for (int i = 0; i < count; ++i)
+    processors.push_back(std::make_unique<VizBeatsAudioProcessor>());
+  result.constructMsPerInstance = (getNowSeconds() - start) * 1000.0 / count;
+
+  start = getNowSeconds();
+  for (auto& processor : processors)
+  {
+    processor->setPlayConfigDetails(2, 2, config.sampleRate, config.blockSize);
+    processor->prepareToPlay(config.sampleRate, config.blockSize);
+
+    // Internal preview play so every instance runs its clock and clicks.
+    setParameter(*processor, "internalPlay", 1.0f);
+
+    if (config.lanes > 0)
+      processor->setPolyrhythmLanes(makeBenchLanes(config.lanes));
+  }
+  result.prepareMsPerInstance = (getNowSeconds() - start) * 1000.0 / count;
+
+  std::vector<std::unique_ptr<juce::AudioProcessorEditor>> editors;
+  if (config.withEditors)
+  {
+    editors.reserve(static_cast<size_t>(count));
+
+    start = getNowSeconds();
+    for (auto& processor : processors)
+      editors.emplace_back(processor->createEditorAndMakeActive());
+    result.createEditorMsPerInstance = (getNowSeconds() - start) * 1000.0 / count;
+
+    start = getNowSeconds();
+    for (auto& editor : editors)
+    {
+      juce::Image frame(juce::Image::RGB, editor->getWidth(), editor->getHeight(), false, juce::SoftwareImageType());
+      juce::Graphics g(frame);
+      editor->paintEntireComponent(g, true);
+    }
+    result.firstFrameMsPerInstance = (getNowSeconds() - start) * 1000.0 / count;
+  }
+
+  {
+    juce::SharedResourcePointer<ClickTableCache> clickTableCache;
+    juce::SharedResourcePointer<GlyphCacheSet> glyphCaches;
+    result.sharedClickTables = clickTableCache->getNumLiveAssets();
+    result.sharedGlyphCaches = glyphCaches->getNumLiveAssets();
+  }
+
+  // One buffer per instance, as each track in a host has its own.
+  std::vector<juce::AudioBuffer<float>> buffers(static_cast<size_t>(count), juce::AudioBuffer<float>(2, config.blockSize));
+  juce::MidiBuffer midi;
+
+  DurationHistogram cycleTimes;
+  double totalCycleSeconds = 0.0;
+
+  const auto cpuStart = getProcessCpuSeconds();
+  for (int cycle = 0; cycle < config.cycles; ++cycle)
+  {
+    const auto cycleStart = getNowSeconds();
+
+    for (size_t i = 0; i < processors.size(); ++i)
+    {
+      buffers[i].clear();
+      processors[i]->processBlock(buffers[i], midi);
+    }
+
+    const auto elapsed = getNowSeconds() - cycleStart;
+    cycleTimes.record(elapsed);
+    totalCycleSeconds += elapsed;
+  }
+  const auto cpuSeconds = getProcessCpuSeconds() - cpuStart;
+
+  const auto blockSeconds = static_cast<double>(config.blockSize) / config.sampleRate;
+  result.cycleMeanMs = totalCycleSeconds * 1000.0 / config.cycles;
+  result.cycleP99Ms = cycleTimes.snapshot().percentile(0.99) * 1000.0;
+  result.cycleCpuMs = cpuSeconds * 1000.0 / config.cycles;
+  result.cycleLoadPercent = 100.0 * (cpuSeconds / config.cycles) / blockSeconds;
+
+  const auto residentAfter = getResidentKb();
+  if (residentBefore >= 0.0 && residentAfter >= 0.0)
+    result.residentKbPerInstance = (residentAfter - residentBefore) / count;
+
+  editors.clear();
+  for (auto& processor : processors)
+    processor->releaseResources();
+
+  return result;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  juce::ScopedJuceInitialiser_GUI juceInit;
+
+  juce::ArgumentList args(argc, argv);
+
+  BenchConfig config;
+  config.withEditors = args.containsOption("--editors");
+  if (args.containsOption("--lanes"))
+    config.lanes = juce::jlimit(0, PolyrhythmLanes::maxLanes, args.getValueForOption("--lanes").getIntValue());
+  if (args.containsOption("--cycles"))
+    config.cycles = juce::jmax(1, args.getValueForOption("--cycles").getIntValue());
+  if (args.containsOption("--block-size"))
+    config.blockSize = juce::jlimit(16, 8192, args.getValueForOption("--block-size").getIntValue());
+  if (args.containsOption("--sample-rate"))
+    config.sampleRate = juce::jlimit(8000.0, 384000.0, args.getValueForOption("--sample-rate").getDoubleValue());
+
+  std::vector<int> counts { 1, 10, 100, 500 };
+  if (args.containsOption("--counts"))
+  {
+    counts.clear();
+    for (const auto& token : juce::StringArray::fromTokens(args.getValueForOption("--counts"), ",", ""))
+      if (token.getIntValue() > 0)
+        counts.push_back(token.getIntValue());
+  }
+
+  const auto csvPath = args.getValueForOption("--csv");
+
+  std::cout << "VizBeats instance benchmark (" << config.cycles << " cycles of " << config.blockSize << " samples at "
+            << config.sampleRate << " Hz" << (config.withEditors ? ", with editors" : "")
+            << (config.lanes > 0 ? ", " + std::to_string(config.lanes) + " lanes" : std::string()) << ")\n";
+  std::cout << "count  construct ms  prepare ms  editor ms  1st frame ms   RSS KiB   cycle ms   p99 ms   cpu ms   load %  clicks  glyphs\n";
+
+  juce::String csv("count,editors,lanes,construct_ms,prepare_ms,create_editor_ms,first_frame_ms,rss_kib,cycle_mean_ms,cycle_p99_ms,cycle_cpu_ms,cycle_load_percent,shared_click_tables,shared_glyph_caches\n");
+
+  for (const auto count : counts)
+  {
+    const auto r = runCount(count, config);
+    const auto rssText = r.residentKbPerInstance >= 0.0 ? juce::String(r.residentKbPerInstance, 1) : juce::String("n/a");
+
+    // Startup columns are per instance; cycle columns cover all instances together.
+    std::cout << juce::String(r.count).paddedLeft(' ', 5)
+              << juce::String(r.constructMsPerInstance, 3).paddedLeft(' ', 14)
+              << juce::String(r.prepareMsPerInstance, 3).paddedLeft(' ', 12)
+              << juce::String(r.createEditorMsPerInstance, 3).paddedLeft(' ', 11)
+              << juce::String(r.firstFrameMsPerInstance, 3).paddedLeft(' ', 14)
+              << rssText.paddedLeft(' ', 10)
+              << juce::String(r.cycleMeanMs, 3).paddedLeft(' ', 11)
+              << juce::String(r.cycleP99Ms, 3).paddedLeft(' ', 9)
+              << juce::String(r.cycleCpuMs, 3).paddedLeft(' ', 9)
+              << juce::String(r.cycleLoadPercent, 2).paddedLeft(' ', 9)
+              << juce::String(static_cast<int>(r.sharedClickTables)).paddedLeft(' ', 8)
+              << juce::String(static_cast<int>(r.sharedGlyphCaches)).paddedLeft(' ', 8) << '\n';
+
+    csv << r.count << ',' << (config.withEditors ? 1 : 0) << ',' << config.lanes << ','
+        << juce::String(r.constructMsPerInstance, 4) << ',' << juce::String(r.prepareMsPerInstance, 4) << ','
+        << juce::String(r.createEditorMsPerInstance, 4) << ',' << juce::String(r.firstFrameMsPerInstance, 4) << ','
+        << juce::String(r.residentKbPerInstance, 1) << ','
+        << juce::String(r.cycleMeanMs, 4) << ',' << juce::String(r.cycleP99Ms, 4) << ','
+        << juce::String(r.cycleCpuMs, 4) << ',' << juce::String(r.cycleLoadPercent, 3) << ','
+        << static_cast<int>(r.sharedClickTables) << ',' << static_cast<int>(r.sharedGlyphCaches) << '\n';
+  }
+
+  if (csvPath.isNotEmpty())
+  {
+    const juce::File csvFile(juce::File::getCurrentWorkingDirectory().getChildFile(csvPath));
+    if (!csvFile.replaceWithText(csv))
+    {
+      std::cerr << "Could not write " << csvFile.getFullPathName() << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,514 @@
+// Headless render benchmark for the editor visualizers.
+//
+// Renders each visual mode into an offscreen software juce::Image for a number of frames
+// across sizes, themes and beat/subdivision counts, and reports ms/frame. It never creates
+// a window, so it runs on display-less Linux machines (CI, render boxes).
+//
+//   VizBeatsRenderBench [--frames=N] [--quick] [--csv=path] [--tiles=N]
+//   VizBeatsRenderBench --check-allocations [--frames=N]
+//   VizBeatsRenderBench --check-budgets [--frames=N]
+//
+// --tiles=N renders Traffic frames through the tiled renderer with N workers (0 = one per
+// core), to check how large frames scale with core count.
+// --check-allocations runs an offscreen editor on an internally playing processor in every
+// visual mode (and Traffic in every render mode), counts heap allocations on the message
+// thread across steady-state frames and exits non-zero if the editor's per-frame update
+// allocates in any of them. Paint is reported separately: JUCE's software rasteriser
+// allocates edge tables internally, which is outside our control. Rasterising on the render
+// thread or the tile workers is paint work too, so those threads aren't counted.
+// --check-budgets renders every framework mode at 1920x1080 and exits non-zero if its mean
+// frame time exceeds the budget the mode declares (BeatModeRenderer::getFrameBudgetMs).
+
+#include <JuceHeader.h>
+
+#include "../Source/BeatModes.h"
+#include "../Source/FrameProfiler.h"
+#include "../Source/PluginEditor.h"
+#include "../Source/PluginProcessor.h"
+#include "../Source/Theme.h"
+#include "../Source/TiledRenderer.h"
+#include "../Source/Visualizers.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <vector>
+
+//==============================================================================
+// Allocation counting. Only armed around the code under test and only on the thread running
+// it, so JUCE start-up, the benchmark's own bookkeeping and other threads don't count.
+#if JUCE_LINUX
+extern "C"
+{
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void __libc_free(void*);
+}
+#endif
+
+namespace
+{
+thread_local bool allocationCountingArmed = false;
+std::atomic<juce::int64> allocationCount { 0 };
+
+void noteAllocation()
+{
+  if (allocationCountingArmed)
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct ScopedAllocationCount
+{
+  ScopedAllocationCount() { allocationCountingArmed = true; }
+  ~ScopedAllocationCount() { allocationCountingArmed = false; }
+};
+
+// On glibc malloc is interposed below as well, so operator new bypasses it; going through
+// it would count every new twice.
+void* allocateUncounted(std::size_t size)
+{
+#if JUCE_LINUX
+  return __libc_malloc(size);
+#else
+  return std::malloc(size);
+#endif
+}
+
+void freeUncounted(void* p)
+{
+#if JUCE_LINUX
+  __libc_free(p);
+#else
+  std::free(p);
+#endif
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  noteAllocation();
+  if (auto* p = allocateUncounted(size == 0 ? 1 : size))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept { freeUncounted(p); }
+void operator delete[](void* p) noexcept { freeUncounted(p); }
+void operator delete(void* p, std::size_t) noexcept { freeUncounted(p); }
+void operator delete[](void* p, std::size_t) noexcept { freeUncounted(p); }
+
+#if JUCE_LINUX
+// JUCE containers (HeapBlock, Array, Path) go straight to malloc, so on glibc the C allocator
+// is interposed as well.
+extern "C"
+{
+void* malloc(std::size_t size)
+{
+  noteAllocation();
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+  noteAllocation();
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, std::size_t size)
+{
+  noteAllocation();
+  return __libc_realloc(p, size);
+}
+}
+#endif
+
+namespace
+{
+struct BenchSize
+{
+  int width;
+  int height;
+};
+
+struct BenchMeter
+{
+  int beatsPerBar;
+  int subdivisions;
+};
+
+struct BenchCase
+{
+  VisualMode mode;
+  BenchSize size;
+  ColorTheme theme;
+  BenchMeter meter;
+};
+
+struct BenchResult
+{
+  double meanMs = 0.0;
+  double p95Ms = 0.0;
+  double maxMs = 0.0;
+};
+
+constexpr double kBenchBpm = 128.0;
+constexpr double kFrameSeconds = 1.0 / 60.0;
+
+const char* getThemeName(ColorTheme theme)
+{
+  switch (theme)
+  {
+    case ColorTheme::CalmBlue: return "CalmBlue";
+    case ColorTheme::WarmSunset: return "WarmSunset";
+    case ColorTheme::ForestMint: return "ForestMint";
+    case ColorTheme::HighContrast:
+    default: break;
+  }
+
+  return "HighContrast";
+}
+
+// Beat position for a synthetic transport running at kBenchBpm.
+void getBeatAt(double seconds, int beatsPerBar, double& phase, int& beatInBar, juce::int64& barIndex)
+{
+  const auto beats = seconds * (kBenchBpm / 60.0);
+  phase = beats - std::floor(beats);
+  beatInBar = static_cast<int>(std::fmod(beats, static_cast<double>(beatsPerBar)));
+  barIndex = static_cast<juce::int64>(std::floor(beats / static_cast<double>(beatsPerBar)));
+}
+
+template <typename Visualizer, typename UpdateFn>
+BenchResult runFrames(Visualizer& viz, const BenchCase& c, int numFrames, UpdateFn&& update)
+{
+  juce::Image image(juce::Image::ARGB, c.size.width, c.size.height, true, juce::SoftwareImageType());
+  viz.setBounds(0, 0, c.size.width, c.size.height);
+  viz.setColors(getThemeColors(c.theme), static_cast<juce::uint32>(c.theme) + 1);
+
+  DurationHistogram histogram;
+  double totalSeconds = 0.0;
+
+  // A few untimed frames so one-off cache builds (flash overlay etc.) don't skew the mean.
+  constexpr int warmupFrames = 5;
+
+  for (int frame = -warmupFrames; frame < numFrames; ++frame)
+  {
+    const auto t = static_cast<double>(frame + warmupFrames) * kFrameSeconds;
+    update(t);
+
+    const auto start = juce::Time::getHighResolutionTicks();
+    {
+      juce::Graphics g(image);
+      viz.paintEntireComponent(g, true);
+    }
+    const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    if (frame >= 0)
+    {
+      histogram.record(elapsed);
+      totalSeconds += elapsed;
+    }
+  }
+
+  const auto snap = histogram.snapshot();
+  BenchResult result;
+  result.meanMs = numFrames > 0 ? totalSeconds * 1000.0 / numFrames : 0.0;
+  result.p95Ms = snap.percentile(0.95) * 1000.0;
+  result.maxMs = snap.maxSeconds * 1000.0;
+  return result;
+}
+
+BeatFrameState getFrameStateAt(const BenchCase& c, double t)
+{
+  BeatFrameState frame;
+  getBeatAt(t, c.meter.beatsPerBar, frame.beatPhase, frame.currentBeat, frame.barIndex);
+  frame.running = true;
+  frame.beatsPerBar = c.meter.beatsPerBar;
+  frame.subdivisions = c.meter.subdivisions;
+  frame.frameTimeSeconds = t;
+  return frame;
+}
+
+BenchResult runCase(const BenchCase& c, int numFrames, TiledRenderer* tiledRenderer)
+{
+  if (c.mode != VisualMode::Traffic)
+  {
+    ModeVisualizer viz(createBeatModeRenderer(c.mode));
+    return runFrames(viz, c, numFrames, [&viz, &c](double t) { viz.applyFrameState(getFrameStateAt(c, t)); });
+  }
+
+  TrafficVisualizer viz;
+  viz.setTiledRenderer(tiledRenderer);
+  return runFrames(viz, c, numFrames, [&viz, &c](double t)
+  {
+    double phase = 0.0;
+    int beat = 0;
+    juce::int64 bar = 0;
+    getBeatAt(t, c.meter.beatsPerBar, phase, beat, bar);
+    viz.setRunning(true);
+    viz.setBeatsPerBar(c.meter.beatsPerBar);
+    viz.setSubdivisions(c.meter.subdivisions);
+    viz.setBeatPhase(phase);
+    viz.setCurrentBeat(beat);
+    viz.setBarIndex(bar);
+    viz.setFrameTime(t);
+    viz.advanceAnimation();
+  });
+}
+
+void setParameter(VizBeatsAudioProcessor& processor, const char* paramId, float value)
+{
+  if (auto* param = processor.apvts.getParameter(paramId))
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+// Editor render modes, as stored in the processor state's "renderMode" property. Only
+// Traffic has more than one.
+const char* const kRenderModeNames[] = { "message", "render thread", "tiled" };
+
+struct AllocationCount
+{
+  juce::int64 frame = 0;
+  juce::int64 paint = 0;
+};
+
+// Runs the whole editor offscreen on a processor in internal play through a warmed-up steady
+// state. Counts allocations in the per-frame work (transport bar, readouts, visualizer
+// update) and in paint separately; the audio block that runs between frames is not counted.
+AllocationCount countEditorAllocations(VisualMode mode, int renderMode, int numFrames)
+{
+  constexpr double sampleRate = 48000.0;
+  const auto blockSize = juce::roundToInt(sampleRate * kFrameSeconds);
+
+  VizBeatsAudioProcessor processor;
+  processor.prepareToPlay(sampleRate, blockSize);
+  processor.apvts.state.setProperty("renderMode", renderMode, nullptr);
+  setParameter(processor, "visualMode", static_cast<float>(mode));
+  setParameter(processor, "colorTheme", static_cast<float>(ColorTheme::CalmBlue));
+  setParameter(processor, "beatsPerBar", 7.0f);
+  setParameter(processor, "subdivisions", 3.0f);
+  setParameter(processor, "internalPlay", 1.0f);
+
+  VizBeatsAudioProcessorEditor editor(processor);
+  juce::Image image(juce::Image::ARGB, editor.getWidth(), editor.getHeight(), true, juce::SoftwareImageType());
+
+  juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+  juce::MidiBuffer midi;
+
+  AllocationCount count;
+
+  // Warm up for a few bars so every cache (sprites, marker layer, flash overlay, glyphs)
+  // exists.
+  constexpr int warmupFrames = 600;
+
+  for (int frame = -warmupFrames; frame < numFrames; ++frame)
+  {
+    const auto t = static_cast<double>(frame + warmupFrames) * kFrameSeconds;
+
+    buffer.clear();
+    processor.processBlock(buffer, midi);
+
+    const bool counting = frame >= 0;
+    allocationCount.store(0);
+    {
+      const ScopedAllocationCount scope;
+      editor.runFrame(t);
+    }
+    if (counting)
+      count.frame += allocationCount.load();
+
+    juce::Graphics g(image);
+    allocationCount.store(0);
+    {
+      const ScopedAllocationCount scope;
+      editor.paintEntireComponent(g, true);
+    }
+    if (counting)
+      count.paint += allocationCount.load();
+  }
+
+  processor.releaseResources();
+  return count;
+}
+
+// Every visual mode on the message thread, plus Traffic on the render thread and tiled.
+int checkAllocations(int numFrames)
+{
+  int failures = 0;
+
+  std::cout << "Allocation check: " << numFrames << " editor frames/case, internal play in 7/8 with 3x subdivisions\n";
+  std::cout << "mode      render          frame allocs   paint allocs/frame\n";
+
+  for (int m = 0; m <= static_cast<int>(VisualMode::Pattern); ++m)
+  {
+    const auto mode = static_cast<VisualMode>(m);
+    const auto numRenderModes = mode == VisualMode::Traffic ? static_cast<int>(std::size(kRenderModeNames)) : 1;
+
+    for (int renderMode = 0; renderMode < numRenderModes; ++renderMode)
+    {
+      const auto count = countEditorAllocations(mode, renderMode, numFrames);
+      failures += count.frame != 0 ? 1 : 0;
+
+      std::cout << juce::String(getVisualModeName(mode)).paddedRight(' ', 10)
+                << juce::String(kRenderModeNames[renderMode]).paddedRight(' ', 16)
+                << juce::String(count.frame).paddedLeft(' ', 12)
+                << juce::String(static_cast<double>(count.paint) / numFrames, 2).paddedLeft(' ', 21)
+                << (count.frame != 0 ? "   ALLOCATES" : "") << '\n';
+    }
+  }
+
+  std::cout << "Paint allocations come from the renderer internals.\n";
+
+  if (failures > 0)
+  {
+    std::cerr << "FAIL: the editor's per-frame update allocated in " << failures << " case(s)\n";
+    return 1;
+  }
+
+  std::cout << "PASS\n";
+  return 0;
+}
+
+// Holds every framework mode to its declared per-frame budget at 1920x1080.
+int checkBudgets(int numFrames)
+{
+  const BenchMeter meters[] = { { 4, 1 }, { 16, 4 } };
+  int failures = 0;
+
+  std::cout << "Budget check: " << numFrames << " frames/case at 1920x1080\n";
+  std::cout << "mode      meter   mean ms   budget ms\n";
+
+  for (int m = 0; m <= static_cast<int>(VisualMode::Pattern); ++m)
+  {
+    const auto mode = static_cast<VisualMode>(m);
+    const auto renderer = createBeatModeRenderer(mode);
+    if (renderer == nullptr)
+      continue;
+
+    const auto budgetMs = renderer->getFrameBudgetMs();
+
+    for (const auto& meter : meters)
+    {
+      const BenchCase c { mode, { 1920, 1080 }, ColorTheme::CalmBlue, meter };
+      const auto r = runCase(c, numFrames, nullptr);
+      const bool overBudget = r.meanMs > budgetMs;
+      failures += overBudget ? 1 : 0;
+
+      const auto meterText = juce::String(meter.beatsPerBar) + "/" + juce::String(meter.subdivisions) + "x";
+      std::cout << juce::String(getVisualModeName(mode)).paddedRight(' ', 10)
+                << meterText.paddedRight(' ', 6)
+                << juce::String(r.meanMs, 3).paddedLeft(' ', 9)
+                << juce::String(budgetMs, 2).paddedLeft(' ', 12)
+                << (overBudget ? "   OVER" : "") << '\n';
+    }
+  }
+
+  if (failures > 0)
+  {
+    std::cerr << "FAIL: " << failures << " case(s) over budget\n";
+    return 1;
+  }
+
+  std::cout << "PASS\n";
+  return 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  juce::ScopedJuceInitialiser_GUI juceInit;
+
+  juce::ArgumentList args(argc, argv);
+  const auto numFrames = juce::jmax(1, args.containsOption("--frames") ? args.getValueForOption("--frames").getIntValue() : 240);
+  const bool quick = args.containsOption("--quick");
+  const auto csvPath = args.getValueForOption("--csv");
+
+  std::unique_ptr<TiledRenderer> tiledRenderer;
+  if (args.containsOption("--tiles"))
+    tiledRenderer = std::make_unique<TiledRenderer>(args.getValueForOption("--tiles").getIntValue());
+
+  if (args.containsOption("--check-allocations"))
+    return checkAllocations(args.containsOption("--frames") ? numFrames : 1000);
+
+  if (args.containsOption("--check-budgets"))
+    return checkBudgets(numFrames);
+
+  const std::vector<VisualMode> modes { VisualMode::Traffic, VisualMode::Pulse, VisualMode::Pendulum,
+                                        VisualMode::Bounce, VisualMode::Ladder, VisualMode::Pattern };
+
+  std::vector<BenchSize> sizes { { 520, 320 }, { 960, 540 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 } };
+  std::vector<ColorTheme> themes { ColorTheme::CalmBlue, ColorTheme::WarmSunset, ColorTheme::ForestMint, ColorTheme::HighContrast };
+  std::vector<BenchMeter> meters { { 4, 1 }, { 7, 3 }, { 16, 4 } };
+
+  if (quick)
+  {
+    sizes = { { 960, 540 }, { 3840, 2160 } };
+    themes = { ColorTheme::CalmBlue };
+    meters = { { 4, 1 }, { 16, 4 } };
+  }
+
+  const auto tileWorkers = tiledRenderer != nullptr ? tiledRenderer->getNumWorkers() : 0;
+
+  juce::String csv("mode,width,height,theme,beats,subdivisions,tile_workers,frames,mean_ms,p95_ms,max_ms\n");
+
+  std::cout << "VizBeats render benchmark (" << numFrames << " frames/case, software renderer";
+  if (tileWorkers > 0)
+    std::cout << ", Traffic tiled on " << tileWorkers << " workers";
+  std::cout << ")\n";
+  std::cout << "mode      size        theme          meter   mean ms   p95 ms   max ms\n";
+
+  for (const auto mode : modes)
+  {
+    for (const auto& size : sizes)
+    {
+      for (const auto theme : themes)
+      {
+        for (const auto& meter : meters)
+        {
+          const BenchCase c { mode, size, theme, meter };
+          const auto r = runCase(c, numFrames, tiledRenderer.get());
+
+          const auto sizeText = juce::String(size.width) + "x" + juce::String(size.height);
+          const auto meterText = juce::String(meter.beatsPerBar) + "/" + juce::String(meter.subdivisions) + "x";
+
+          const juce::String modeName(getVisualModeName(mode));
+
+          std::cout << modeName.paddedRight(' ', 10)
+                    << sizeText.paddedRight(' ', 12)
+                    << juce::String(getThemeName(theme)).paddedRight(' ', 15)
+                    << meterText.paddedRight(' ', 6)
+                    << juce::String(r.meanMs, 3).paddedLeft(' ', 9)
+                    << juce::String(r.p95Ms, 3).paddedLeft(' ', 9)
+                    << juce::String(r.maxMs, 3).paddedLeft(' ', 9) << '\n';
+
+          csv << modeName << ',' << size.width << ',' << size.height << ',' << getThemeName(theme) << ','
+              << meter.beatsPerBar << ',' << meter.subdivisions << ',' << (mode == VisualMode::Traffic ? tileWorkers : 0) << ','
+              << numFrames << ','
+              << juce::String(r.meanMs, 4) << ',' << juce::String(r.p95Ms, 4) << ',' << juce::String(r.maxMs, 4) << '\n';
+        }
+      }
+    }
+  }
+
+  if (csvPath.isNotEmpty())
+  {
+    const juce::File csvFile(juce::File::getCurrentWorkingDirectory().getChildFile(csvPath));
+    if (!csvFile.replaceWithText(csv))
+    {
+      std::cerr << "Could not write " << csvFile.getFullPathName() << '\n';
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "BarPosition.h"
+
+namespace
+{
+constexpr int kMaxNumerator = 64;
+
+// Hosts round positions, so a block starting on a bar line can report a PPQ just before the
+// bar start it also reports.
+constexpr double kBarStartToleranceQuarters = 1.0e-6;
+
+int sanitiseBeatsPerBar(int beatsPerBar) noexcept
+{
+  return juce::jlimit(1, kMaxNumerator, beatsPerBar);
+}
+} // namespace
+
+BarPosition BarPosition::fromBeats(double beats, int beatsPerBar) noexcept
+{
+  BarPosition position;
+  position.numerator = sanitiseBeatsPerBar(beatsPerBar);
+  position.denominator = 4;
+
+  const auto barLength = static_cast<double>(position.numerator);
+  const auto bar = std::floor(beats / barLength);
+  position.barIndex = static_cast<juce::int64>(bar);
+  position.beatInBar = juce::jlimit(0.0, barLength, beats - bar * barLength);
+  return position;
+}
+
+BarPosition BarPosition::fromPpq(double ppq,
+                                 const juce::Optional<juce::AudioPlayHead::TimeSignature>& timeSignature,
+                                 const juce::Optional<double>& lastBarStartPpq,
+                                 const juce::Optional<juce::int64>& barCount,
+                                 int fallbackBeatsPerBar) noexcept
+{
+  BarPosition position;
+  position.numerator = sanitiseBeatsPerBar(fallbackBeatsPerBar);
+  position.denominator = 4;
+
+  // Denominators other than powers of two don't exist in practice; treat them as unusable.
+  if (timeSignature && timeSignature->numerator > 0 && timeSignature->numerator <= kMaxNumerator
+      && timeSignature->denominator > 0 && juce::isPowerOfTwo(timeSignature->denominator))
+  {
+    position.numerator = timeSignature->numerator;
+    position.denominator = timeSignature->denominator;
+  }
+
+  const auto quartersPerBeat = position.getQuartersPerBeat();
+  const auto barLength = static_cast<double>(position.numerator) * quartersPerBeat;
+
+  bool hostBarStart = false;
+  double barStart = 0.0;
+  juce::int64 barsAfterHostBarStart = 0;
+
+  if (lastBarStartPpq && std::isfinite(*lastBarStartPpq) && *lastBarStartPpq <= ppq + kBarStartToleranceQuarters)
+  {
+    hostBarStart = true;
+    barStart = juce::jmin(*lastBarStartPpq, ppq);
+
+    // A bar start from before the current meter (or simply stale) is moved up to the bar
+    // that contains the position.
+    const auto sinceBarStart = ppq - barStart;
+    if (sinceBarStart >= barLength)
+    {
+      const auto bars = std::floor(sinceBarStart / barLength);
+      barStart += bars * barLength;
+      barsAfterHostBarStart = static_cast<juce::int64>(bars);
+    }
+  }
+  else
+  {
+    barStart = std::floor(ppq / barLength) * barLength;
+  }
+
+  if (hostBarStart && barCount)
+    position.barIndex = *barCount + barsAfterHostBarStart;
+  else
+    position.barIndex = static_cast<juce::int64>(std::floor((barStart + kBarStartToleranceQuarters) / barLength));
+
+  position.beatInBar = juce::jlimit(0.0, static_cast<double>(position.numerator), (ppq - barStart) / quartersPerBeat);
+  return position;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Where a beat position falls in the bar: resolved once per block on the audio thread and
+// shared with the editor, so clicks, accents and the bar.beat readout agree.
+//
+// Beats are the meter's beats (eighths in 7/8, quarters in 3/4), not PPQ quarter notes. The
+// host's time signature and last bar start are used when it supplies them, so pickups and
+// meter changes land on the host's bar lines; otherwise bars are beatsPerBar quarters long
+// and counted from zero.
+struct BarPosition
+{
+  int numerator = 4;
+  int denominator = 4;
+  juce::int64 barIndex = 0; // 0 = the bar starting at beat 0 (readout bar 1)
+  double beatInBar = 0.0;   // meter beats since the bar line, in [0, numerator)
+
+  // Without host meter information: beatsPerBar quarter-note beats per bar.
+  static BarPosition fromBeats(double beats, int beatsPerBar) noexcept;
+
+  // From the host position. Missing or unusable fields fall back to fallbackBeatsPerBar.
+  static BarPosition fromPpq(double ppq,
+                             const juce::Optional<juce::AudioPlayHead::TimeSignature>& timeSignature,
+                             const juce::Optional<double>& lastBarStartPpq,
+                             const juce::Optional<juce::int64>& barCount,
+                             int fallbackBeatsPerBar) noexcept;
+
+  double getQuartersPerBeat() const noexcept { return 4.0 / static_cast<double>(denominator); }
+
+  // Beats since beat 0 of bar 0; whole numbers fall on the meter's beats.
+  double getBeatPosition() const noexcept { return static_cast<double>(barIndex) * numerator + beatInBar; }
+
+  int getBeatIndex() const noexcept { return juce::jlimit(0, numerator - 1, static_cast<int>(beatInBar)); }
+  double getBeatPhase() const noexcept { return beatInBar - std::floor(beatInBar); }
+
+  bool operator==(const BarPosition& other) const noexcept
+  {
+    return numerator == other.numerator && denominator == other.denominator && barIndex == other.barIndex
+           && beatInBar == other.beatInBar;
+  }
+
+  bool operator!=(const BarPosition& other) const noexcept { return !operator==(other); }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PolyrhythmLanes.h"
+#include "QualityGovernor.h"
+
+// Per-frame inputs shared by every visual mode, as a plain value so it can be handed to a
+// render thread.
+struct BeatFrameState
+{
+  double beatPhase = 0.0;
+  bool running = false;
+  int beatsPerBar = 4;
+  int subdivisions = 1;
+  int currentBeat = 0;
+  juce::int64 barIndex = 0;
+  juce::uint32 discontinuityGeneration = 0; // changes when the position jumps (seek, loop)
+  PolyrhythmLanes lanes;
+  double frameTimeSeconds = 0.0;
+  QualitySettings quality;
+};
+
+// Identifies a cached layer image: it only needs re-rendering when one of these changes.
+struct LayerCacheKey
+{
+  int width = 0;
+  int height = 0;
+  float scale = 0.0f;
+  juce::uint32 themeGeneration = 0;
+  int beatsPerBar = 0;
+  int subdivisions = 0;
+  juce::uint32 lanesGeneration = 0;
+
+  bool operator==(const LayerCacheKey& other) const noexcept
+  {
+    return width == other.width && height == other.height && scale == other.scale
+           && themeGeneration == other.themeGeneration && beatsPerBar == other.beatsPerBar
+           && subdivisions == other.subdivisions && lanesGeneration == other.lanesGeneration;
+  }
+
+  bool operator!=(const LayerCacheKey& other) const noexcept { return !operator==(other); }
+};
@@ -0,0 +1,601 @@
+#include "BeatModes.h"
+
+#include <cmath>
+
+namespace
+{
+float clamp01(float v)
+{
+  return juce::jlimit(0.0f, 1.0f, v);
+}
+
+// Pulse smoothing time constant: the former 0.28 per frame at 60 Hz, now independent of the
+// display rate and the quality governor's frame cap.
+constexpr float kPulseSmoothingSeconds = 0.0507f;
+constexpr float kNominalFrameSeconds = 1.0f / 60.0f;
+
+// A soft radial glow rendered once per size/theme/scale and blitted with an opacity.
+struct GlowSprite
+{
+  juce::Image image;
+  float logicalSize = 0.0f;
+  float scale = 1.0f;
+
+  void render(juce::Colour colour, float diameter, float physicalScale)
+  {
+    logicalSize = juce::jmax(1.0f, diameter);
+    scale = physicalScale;
+
+    const auto px = juce::jmax(1, static_cast<int>(std::ceil(logicalSize * scale)));
+    image = juce::Image(juce::Image::ARGB, px, px, true, juce::SoftwareImageType());
+
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    const auto c = logicalSize * 0.5f;
+    g.setGradientFill(juce::ColourGradient(colour, c, c, colour.withAlpha(0.0f), logicalSize, c, true));
+    g.fillEllipse(0.0f, 0.0f, logicalSize, logicalSize);
+  }
+
+  void draw(juce::Graphics& g, juce::Point<float> centre, float opacity) const
+  {
+    if (image.isNull() || opacity <= 0.0f)
+      return;
+
+    // Snap to the physical pixel grid so the blit stays an untransformed copy.
+    const auto half = logicalSize * 0.5f;
+    const auto x = std::round((centre.x - half) * scale) / scale;
+    const auto y = std::round((centre.y - half) * scale) / scale;
+
+    g.setOpacity(juce::jmin(1.0f, opacity));
+    g.drawImageTransformed(image, juce::AffineTransform::scale(1.0f / scale).translated(x, y));
+  }
+};
+
+// Beats elapsed in the bar, 0..beatsPerBar.
+double getBarBeats(const BeatFrameState& frame)
+{
+  return frame.running ? static_cast<double>(frame.currentBeat) + juce::jlimit(0.0, 1.0, frame.beatPhase) : 0.0;
+}
+
+//==============================================================================
+// Pulse: a ring that flashes out from the centre on every beat.
+class PulseRenderer final : public BeatModeRenderer
+{
+public:
+  VisualMode getMode() const noexcept override { return VisualMode::Pulse; }
+  double getFrameBudgetMs() const noexcept override { return 3.0; }
+
+  void advance(const BeatFrameState& frame) override
+  {
+    // A beat wrap forces a full flash even if the frame landed late in the new beat.
+    const bool wrapped = frame.running && wasRunning && frame.beatPhase < lastPhase;
+    const float target = frame.running ? (wrapped ? 1.0f : pulseFromBeatPhase(frame.beatPhase)) : 0.0f;
+
+    // Snappier response (fast flash per beat), from frame time so it decays at the same speed
+    // at 30, 60 or 144 Hz.
+    const auto dtSeconds = lastFrameTimeSeconds >= 0.0
+                               ? juce::jlimit(0.0f, 0.10f, static_cast<float>(frame.frameTimeSeconds - lastFrameTimeSeconds))
+                               : kNominalFrameSeconds;
+    lastFrameTimeSeconds = frame.frameTimeSeconds;
+
+    const auto smoothing = 1.0f - std::exp(-dtSeconds / kPulseSmoothingSeconds);
+    smoothedPulse = smoothedPulse * (1.0f - smoothing) + target * smoothing;
+
+    lastPhase = frame.beatPhase;
+    wasRunning = frame.running;
+  }
+
+  void paintStaticLayer(juce::Graphics& g, const BeatModeContext& context) override
+  {
+    g.setColour(context.theme.background);
+    g.fillRect(context.bounds);
+
+    const auto size = juce::jmin(context.bounds.getWidth(), context.bounds.getHeight());
+    glow.render(context.theme.accent.withAlpha(0.28f), size * 0.22f, context.scale);
+  }
+
+  void paintDynamicLayer(juce::Graphics& g, const BeatModeContext& context) const override
+  {
+    const auto& theme = context.theme;
+    const auto bounds = context.bounds;
+    const auto size = juce::jmin(bounds.getWidth(), bounds.getHeight());
+    const auto centre = bounds.getCentre();
+
+    const auto maxRadius = size * 0.60f;
+    const auto minRadius = size * 0.10f;
+
+    const auto decay = context.frame.running ? smoothedPulse : 0.0f;
+    const auto radius = minRadius + (maxRadius - minRadius) * decay;
+
+    const auto alpha = 0.14f + 0.82f * decay;
+    const auto stroke = juce::jlimit(1.4f, 9.5f, maxRadius * (0.010f + 0.024f * decay));
+
+    const auto ringBounds = juce::Rectangle<float>(radius * 2.0f, radius * 2.0f).withCentre(centre);
+
+    g.setColour(theme.accent.withAlpha(alpha * 0.42f));
+    g.fillEllipse(ringBounds);
+
+    g.setColour(theme.accent.withAlpha(alpha * 0.78f));
+    g.drawEllipse(ringBounds, stroke * 1.05f);
+
+    // soft glow behind the core
+    if (context.frame.quality.softGlow)
+      glow.draw(g, centre, decay);
+
+    const auto coreRadius = size * 0.085f;
+    const auto coreBounds = juce::Rectangle<float>(coreRadius * 2.0f, coreRadius * 2.0f).withCentre(centre);
+
+    g.setColour(theme.accentSecondary.withAlpha(0.97f));
+    g.drawEllipse(coreBounds, stroke * 0.65f);
+
+    const auto dotRadius = juce::jmax(2.6f, size * 0.011f);
+    g.fillEllipse(juce::Rectangle<float>(dotRadius * 2.0f, dotRadius * 2.0f).withCentre(centre));
+  }
+
+private:
+  // Fast flash per beat: strong at phase=0, quickly decays.
+  static float pulseFromBeatPhase(double beatPhase)
+  {
+    const auto phase = clamp01(static_cast<float>(beatPhase));
+    const auto decay = std::exp(-20.0f * phase);
+    return clamp01(decay * decay * 1.15f);
+  }
+
+  GlowSprite glow;
+  float smoothedPulse = 1.0f;
+  double lastPhase = 0.0;
+  double lastFrameTimeSeconds = -1.0;
+  bool wasRunning = false;
+};
+
+//==============================================================================
+// Pendulum: a metronome arm that reaches an extreme on every beat.
+class PendulumRenderer final : public BeatModeRenderer
+{
+public:
+  VisualMode getMode() const noexcept override { return VisualMode::Pendulum; }
+  double getFrameBudgetMs() const noexcept override { return 3.0; }
+
+  void paintStaticLayer(juce::Graphics& g, const BeatModeContext& context) override
+  {
+    const auto& theme = context.theme;
+    const auto l = getLayout(context.bounds);
+
+    g.setColour(theme.background);
+    g.fillRect(context.bounds);
+
+    // Arc traced by the bob.
+    juce::Path arc;
+    arc.addCentredArc(l.pivot.x, l.pivot.y, l.armLength, l.armLength, 0.0f,
+                      juce::MathConstants<float>::pi - maxAngle, juce::MathConstants<float>::pi + maxAngle, true);
+    g.setColour(theme.textMuted.withAlpha(0.18f));
+    g.strokePath(arc, juce::PathStrokeType(2.0f));
+
+    // Ticks at both extremes (the beats) and at the centre.
+    const auto drawTick = [&g, &l](float angle, float length, float thickness)
+    {
+      const auto dir = juce::Point<float>(std::sin(angle), std::cos(angle));
+      const auto a = l.pivot + dir * (l.armLength - length * 0.5f);
+      const auto b = l.pivot + dir * (l.armLength + length * 0.5f);
+      g.drawLine(a.x, a.y, b.x, b.y, thickness);
+    };
+
+    g.setColour(theme.barMarker.withAlpha(0.45f));
+    drawTick(-maxAngle, 22.0f, 3.0f);
+    drawTick(maxAngle, 22.0f, 3.0f);
+
+    g.setColour(theme.textMuted.withAlpha(0.30f));
+    drawTick(0.0f, 12.0f, 1.5f);
+
+    // Pivot
+    g.setColour(theme.textMuted.withAlpha(0.55f));
+    g.fillEllipse(juce::Rectangle<float>(10.0f, 10.0f).withCentre(l.pivot));
+
+    glow.render(theme.accent.withAlpha(0.45f), bobRadius * 5.0f, context.scale);
+  }
+
+  void paintDynamicLayer(juce::Graphics& g, const BeatModeContext& context) const override
+  {
+    const auto& theme = context.theme;
+    const auto& frame = context.frame;
+    const auto l = getLayout(context.bounds);
+
+    // At an extreme on every beat, swinging through the centre in between.
+    const auto beats = getBarBeats(frame);
+    const auto angle = frame.running ? maxAngle * static_cast<float>(std::cos(juce::MathConstants<double>::pi * beats)) : 0.0f;
+    const auto bob = l.pivot + juce::Point<float>(std::sin(angle), std::cos(angle)) * l.armLength;
+
+    const auto phase = clamp01(static_cast<float>(frame.beatPhase));
+    const auto hit = frame.running ? std::exp(-phase * phase * 60.0f) : 0.0f;
+    const bool downbeat = frame.currentBeat == 0;
+
+    if (frame.quality.softGlow)
+      glow.draw(g, bob, hit * (downbeat ? 1.0f : 0.65f));
+
+    g.setColour(theme.accent.withAlpha(0.85f));
+    g.drawLine(l.pivot.x, l.pivot.y, bob.x, bob.y, 3.0f);
+
+    g.setColour((downbeat ? theme.accentSecondary : juce::Colours::white).withAlpha(0.92f + 0.08f * hit));
+    g.fillEllipse(juce::Rectangle<float>(bobRadius * 2.0f, bobRadius * 2.0f).withCentre(bob));
+  }
+
+private:
+  static constexpr float maxAngle = 0.45f; // radians either side of vertical
+  static constexpr float bobRadius = 14.0f;
+
+  struct Layout
+  {
+    juce::Point<float> pivot;
+    float armLength = 0.0f;
+  };
+
+  static Layout getLayout(juce::Rectangle<float> bounds)
+  {
+    Layout l;
+    l.pivot = { bounds.getCentreX(), bounds.getY() + bounds.getHeight() * 0.12f };
+    const auto maxByHeight = bounds.getHeight() * 0.72f;
+    const auto maxByWidth = (bounds.getWidth() * 0.5f - 60.0f) / std::sin(maxAngle);
+    l.armLength = juce::jmax(40.0f, juce::jmin(maxByHeight, maxByWidth));
+    return l;
+  }
+
+  GlowSprite glow;
+};
+
+//==============================================================================
+// Bounce: a ball hopping from beat to beat along a floor.
+class BounceRenderer final : public BeatModeRenderer
+{
+public:
+  VisualMode getMode() const noexcept override { return VisualMode::Bounce; }
+  double getFrameBudgetMs() const noexcept override { return 3.0; }
+
+  void paintStaticLayer(juce::Graphics& g, const BeatModeContext& context) override
+  {
+    const auto& theme = context.theme;
+    const auto& frame = context.frame;
+    const auto l = getLayout(context.bounds, frame.beatsPerBar);
+
+    g.setColour(theme.background);
+    g.fillRect(context.bounds);
+
+    // Floor
+    g.setColour(theme.textMuted.withAlpha(0.22f));
+    g.drawLine(l.startX - 20.0f, l.floorY, l.endX + 20.0f, l.floorY, 1.0f);
+
+    // Subdivision ticks between the beat slots.
+    const auto subs = juce::jmax(1, frame.subdivisions);
+    g.setColour(theme.textMuted.withAlpha(0.20f));
+    for (int beat = 0; beat < l.beats; ++beat)
+    {
+      for (int sub = 1; sub < subs; ++sub)
+      {
+        const auto x = l.getSlotX(beat) + l.spacing * static_cast<float>(sub) / static_cast<float>(subs);
+        g.fillRect(x - 0.5f, l.floorY - 3.0f, 1.0f, 6.0f);
+      }
+    }
+
+    // Beat slots: the downbeat slot uses the bar colour.
+    for (int beat = 0; beat < l.beats; ++beat)
+    {
+      g.setColour(beat == 0 ? theme.barMarker.withAlpha(0.55f) : theme.textMuted.withAlpha(0.35f));
+      g.drawEllipse(juce::Rectangle<float>(slotWidth, slotHeight).withCentre({ l.getSlotX(beat), l.floorY }), 1.3f);
+    }
+
+    glow.render(theme.accent.withAlpha(0.40f), ballRadius * 4.0f, context.scale);
+  }
+
+  void paintDynamicLayer(juce::Graphics& g, const BeatModeContext& context) const override
+  {
+    const auto& theme = context.theme;
+    const auto& frame = context.frame;
+    const auto l = getLayout(context.bounds, frame.beatsPerBar);
+
+    const auto phase = frame.running ? clamp01(static_cast<float>(frame.beatPhase)) : 0.0f;
+    const auto beat = frame.running ? juce::jlimit(0, l.beats - 1, frame.currentBeat) : 0;
+    const auto nextBeat = (beat + 1) % l.beats;
+
+    // Lands on a slot at every beat; the last beat arcs back to the downbeat.
+    const auto fromX = l.getSlotX(beat);
+    const auto toX = l.getSlotX(nextBeat);
+    const auto x = fromX + (toX - fromX) * phase;
+
+    const auto height01 = 4.0f * phase * (1.0f - phase);
+    const auto y = l.floorY - ballRadius - height01 * l.bounceHeight;
+
+    // Impact: flash the slot being hit and squash the ball.
+    const auto impact = frame.running ? juce::jmax(std::exp(-phase * 25.0f), std::exp(-(1.0f - phase) * 25.0f)) : 0.0f;
+    if (frame.running && phase < 0.2f)
+    {
+      g.setColour((beat == 0 ? theme.barMarker : theme.accent).withAlpha(0.45f * (1.0f - phase / 0.2f)));
+      g.fillEllipse(juce::Rectangle<float>(slotWidth, slotHeight).withCentre({ fromX, l.floorY }));
+    }
+
+    // Shadow on the floor
+    const auto shadowW = ballRadius * 2.4f * (1.0f - 0.6f * height01);
+    g.setColour(juce::Colours::black.withAlpha(0.28f * (1.0f - 0.7f * height01)));
+    g.fillEllipse(juce::Rectangle<float>(shadowW, shadowW * 0.25f).withCentre({ x, l.floorY + 2.0f }));
+
+    if (frame.quality.softGlow)
+      glow.draw(g, { x, y }, 0.35f + 0.65f * impact);
+
+    const auto squash = 0.22f * impact;
+    const auto ballW = ballRadius * 2.0f * (1.0f + squash);
+    const auto ballH = ballRadius * 2.0f * (1.0f - squash);
+    g.setColour(beat == 0 && phase < 0.5f ? theme.accentSecondary : theme.accent);
+    g.fillEllipse(juce::Rectangle<float>(ballW, ballH).withCentre({ x, y + (ballRadius * 2.0f - ballH) * 0.5f }));
+  }
+
+private:
+  static constexpr float ballRadius = 13.0f;
+  static constexpr float slotWidth = 22.0f;
+  static constexpr float slotHeight = 8.0f;
+
+  struct Layout
+  {
+    int beats = 1;
+    float startX = 0.0f;
+    float endX = 0.0f;
+    float spacing = 0.0f;
+    float floorY = 0.0f;
+    float bounceHeight = 0.0f;
+
+    float getSlotX(int beat) const noexcept { return startX + (static_cast<float>(beat) + 0.5f) * spacing; }
+  };
+
+  static Layout getLayout(juce::Rectangle<float> bounds, int beatsPerBar)
+  {
+    Layout l;
+    l.beats = juce::jmax(1, beatsPerBar);
+    l.startX = bounds.getX() + 88.0f;
+    l.endX = bounds.getRight() - 88.0f;
+    l.spacing = (l.endX - l.startX) / static_cast<float>(l.beats);
+    l.floorY = bounds.getBottom() - bounds.getHeight() * 0.22f;
+    l.bounceHeight = bounds.getHeight() * 0.45f;
+    return l;
+  }
+
+  GlowSprite glow;
+};
+
+//==============================================================================
+// Ladder: one rung per beat, climbed from the bottom once per bar.
+class LadderRenderer final : public BeatModeRenderer
+{
+public:
+  VisualMode getMode() const noexcept override { return VisualMode::Ladder; }
+  double getFrameBudgetMs() const noexcept override { return 2.5; }
+
+  void paintStaticLayer(juce::Graphics& g, const BeatModeContext& context) override
+  {
+    const auto& theme = context.theme;
+    const auto& frame = context.frame;
+    const auto l = getLayout(context.bounds, frame.beatsPerBar);
+
+    g.setColour(theme.background);
+    g.fillRect(context.bounds);
+
+    // Rails
+    g.setColour(theme.textMuted.withAlpha(0.30f));
+    g.fillRect(l.left - railWidth, l.top, railWidth, l.bottom - l.top);
+    g.fillRect(l.right, l.top, railWidth, l.bottom - l.top);
+
+    // Subdivision notches on the rails.
+    const auto subs = juce::jmax(1, frame.subdivisions);
+    g.setColour(theme.textMuted.withAlpha(0.22f));
+    for (int beat = 0; beat < l.beats; ++beat)
+    {
+      for (int sub = 1; sub < subs; ++sub)
+      {
+        const auto y = l.getRungY(beat) - l.spacing * static_cast<float>(sub) / static_cast<float>(subs);
+        g.fillRect(l.left - railWidth - 6.0f, y - 0.5f, 6.0f, 1.0f);
+        g.fillRect(l.right + railWidth, y - 0.5f, 6.0f, 1.0f);
+      }
+    }
+
+    // Rungs at rest; the downbeat rung uses the bar colour.
+    for (int beat = 0; beat < l.beats; ++beat)
+    {
+      g.setColour(beat == 0 ? theme.barMarker.withAlpha(0.45f) : theme.textMuted.withAlpha(0.25f));
+      g.fillRect(l.left, l.getRungY(beat) - rungHeight * 0.5f, l.right - l.left, rungHeight);
+    }
+
+    glow.render(theme.accent.withAlpha(0.35f), (l.right - l.left) * 0.6f, context.scale);
+  }
+
+  void paintDynamicLayer(juce::Graphics& g, const BeatModeContext& context) const override
+  {
+    const auto& theme = context.theme;
+    const auto& frame = context.frame;
+    const auto l = getLayout(context.bounds, frame.beatsPerBar);
+
+    if (!frame.running)
+      return;
+
+    const auto beat = juce::jlimit(0, l.beats - 1, frame.currentBeat);
+    const auto phase = clamp01(static_cast<float>(frame.beatPhase));
+
+    // Rungs already climbed this bar stay lit.
+    g.setColour(theme.accent.withAlpha(0.22f));
+    for (int i = 0; i < beat; ++i)
+      g.fillRect(l.left, l.getRungY(i) - rungHeight * 0.5f, l.right - l.left, rungHeight);
+
+    // The current rung flashes on the beat and settles.
+    const auto rungY = l.getRungY(beat);
+    if (frame.quality.softGlow)
+      glow.draw(g, { (l.left + l.right) * 0.5f, rungY }, 1.0f - phase);
+
+    g.setColour((beat == 0 ? theme.accentSecondary : theme.accent).withAlpha(0.45f + 0.55f * (1.0f - phase)));
+    g.fillRect(l.left, rungY - rungHeight, l.right - l.left, rungHeight * 2.0f);
+
+    // Climber marker between the rails, moving up towards the next rung.
+    const auto climberY = rungY - phase * l.spacing;
+    g.setColour(juce::Colours::white.withAlpha(0.9f));
+    g.fillRect(l.left - railWidth - 4.0f, climberY - 1.5f, l.right - l.left + railWidth * 2.0f + 8.0f, 3.0f);
+  }
+
+private:
+  static constexpr float railWidth = 4.0f;
+  static constexpr float rungHeight = 4.0f;
+
+  struct Layout
+  {
+    int beats = 1;
+    float left = 0.0f;
+    float right = 0.0f;
+    float top = 0.0f;
+    float bottom = 0.0f;
+    float spacing = 0.0f;
+
+    // Beat 0 is the bottom rung.
+    float getRungY(int beat) const noexcept { return bottom - spacing * (static_cast<float>(beat) + 0.5f); }
+  };
+
+  static Layout getLayout(juce::Rectangle<float> bounds, int beatsPerBar)
+  {
+    Layout l;
+    l.beats = juce::jmax(1, beatsPerBar);
+    const auto halfWidth = juce::jlimit(40.0f, 110.0f, bounds.getWidth() * 0.09f);
+    l.left = bounds.getCentreX() - halfWidth;
+    l.right = bounds.getCentreX() + halfWidth;
+    l.top = bounds.getY() + bounds.getHeight() * 0.08f;
+    l.bottom = bounds.getBottom() - bounds.getHeight() * 0.08f;
+    l.spacing = (l.bottom - l.top) / static_cast<float>(l.beats);
+    return l;
+  }
+
+  GlowSprite glow;
+};
+
+//==============================================================================
+// Pattern: a step grid with one column per beat and one row per subdivision.
+class PatternRenderer final : public BeatModeRenderer
+{
+public:
+  VisualMode getMode() const noexcept override { return VisualMode::Pattern; }
+  double getFrameBudgetMs() const noexcept override { return 2.5; }
+
+  void paintStaticLayer(juce::Graphics& g, const BeatModeContext& context) override
+  {
+    const auto& theme = context.theme;
+    const auto& frame = context.frame;
+    const auto l = getLayout(context.bounds, frame.beatsPerBar, frame.subdivisions);
+
+    g.setColour(theme.background);
+    g.fillRect(context.bounds);
+
+    for (int beat = 0; beat < l.beats; ++beat)
+    {
+      for (int sub = 0; sub < l.subs; ++sub)
+      {
+        const bool downbeat = beat == 0 && sub == 0;
+        const bool mainBeat = sub == 0;
+        g.setColour(downbeat ? theme.barMarker.withAlpha(0.55f)
+                             : theme.textMuted.withAlpha(mainBeat ? 0.38f : 0.22f));
+        g.drawRoundedRectangle(l.getCell(beat, sub), 5.0f, mainBeat ? 1.4f : 1.0f);
+      }
+    }
+
+    glow.render(theme.accent.withAlpha(0.40f), juce::jmax(l.cellWidth, l.cellHeight) * 2.0f, context.scale);
+  }
+
+  void paintDynamicLayer(juce::Graphics& g, const BeatModeContext& context) const override
+  {
+    const auto& theme = context.theme;
+    const auto& frame = context.frame;
+    const auto l = getLayout(context.bounds, frame.beatsPerBar, frame.subdivisions);
+
+    if (!frame.running)
+      return;
+
+    // Steps are read column by column: beat 1 sub 1..n, beat 2 sub 1..n, ...
+    const auto stepPosition = getBarBeats(frame) * static_cast<double>(l.subs);
+    const auto totalSteps = l.beats * l.subs;
+    const auto currentStep = juce::jlimit(0, totalSteps - 1, static_cast<int>(std::floor(stepPosition)));
+    const auto stepPhase = clamp01(static_cast<float>(stepPosition - std::floor(stepPosition)));
+
+    g.setColour(theme.accent.withAlpha(0.20f));
+    for (int step = 0; step < currentStep; ++step)
+      g.fillRect(l.getCell(step / l.subs, step % l.subs).reduced(3.0f));
+
+    const auto cell = l.getCell(currentStep / l.subs, currentStep % l.subs);
+    if (frame.quality.softGlow)
+      glow.draw(g, cell.getCentre(), 1.0f - stepPhase);
+
+    const bool mainBeat = currentStep % l.subs == 0;
+    g.setColour((currentStep == 0 ? theme.accentSecondary : theme.accent).withAlpha((mainBeat ? 0.55f : 0.40f) + 0.45f * (1.0f - stepPhase)));
+    g.fillRect(cell.reduced(2.0f));
+  }
+
+private:
+  struct Layout
+  {
+    int beats = 1;
+    int subs = 1;
+    float x = 0.0f;
+    float y = 0.0f;
+    float cellWidth = 0.0f;
+    float cellHeight = 0.0f;
+    float gap = 8.0f;
+
+    juce::Rectangle<float> getCell(int beat, int sub) const noexcept
+    {
+      return { x + static_cast<float>(beat) * (cellWidth + gap), y + static_cast<float>(sub) * (cellHeight + gap), cellWidth, cellHeight };
+    }
+  };
+
+  static Layout getLayout(juce::Rectangle<float> bounds, int beatsPerBar, int subdivisions)
+  {
+    Layout l;
+    l.beats = juce::jmax(1, beatsPerBar);
+    l.subs = juce::jmax(1, subdivisions);
+
+    const auto area = bounds.reduced(88.0f, bounds.getHeight() * 0.18f);
+    const auto maxCellW = (area.getWidth() - l.gap * static_cast<float>(l.beats - 1)) / static_cast<float>(l.beats);
+    const auto maxCellH = (area.getHeight() - l.gap * static_cast<float>(l.subs - 1)) / static_cast<float>(l.subs);
+    l.cellWidth = juce::jmax(4.0f, juce::jmin(maxCellW, 90.0f));
+    l.cellHeight = juce::jmax(4.0f, juce::jmin(maxCellH, l.cellWidth));
+
+    const auto gridW = l.cellWidth * static_cast<float>(l.beats) + l.gap * static_cast<float>(l.beats - 1);
+    const auto gridH = l.cellHeight * static_cast<float>(l.subs) + l.gap * static_cast<float>(l.subs - 1);
+    l.x = area.getCentreX() - gridW * 0.5f;
+    l.y = area.getCentreY() - gridH * 0.5f;
+    return l;
+  }
+
+  GlowSprite glow;
+};
+} // namespace
+
+std::unique_ptr<BeatModeRenderer> createBeatModeRenderer(VisualMode mode)
+{
+  switch (mode)
+  {
+    case VisualMode::Pulse: return std::make_unique<PulseRenderer>();
+    case VisualMode::Pendulum: return std::make_unique<PendulumRenderer>();
+    case VisualMode::Bounce: return std::make_unique<BounceRenderer>();
+    case VisualMode::Ladder: return std::make_unique<LadderRenderer>();
+    case VisualMode::Pattern: return std::make_unique<PatternRenderer>();
+    case VisualMode::Traffic:
+    default: break;
+  }
+
+  return nullptr;
+}
+
+const char* getVisualModeName(VisualMode mode) noexcept
+{
+  switch (mode)
+  {
+    case VisualMode::Pulse: return "Pulse";
+    case VisualMode::Traffic: return "Traffic";
+    case VisualMode::Pendulum: return "Pendulum";
+    case VisualMode::Bounce: return "Bounce";
+    case VisualMode::Ladder: return "Ladder";
+    case VisualMode::Pattern: return "Pattern";
+    default: break;
+  }
+
+  return "Traffic";
+}
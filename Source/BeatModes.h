@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "BeatFrame.h"
+#include "PluginProcessor.h"
+#include "Theme.h"
+
+#include <memory>
+
+// Everything a mode renderer gets to draw one frame.
+struct BeatModeContext
+{
+  juce::Rectangle<float> bounds;
+  const ThemeColors& theme;
+  const BeatFrameState& frame;
+  float scale = 1.0f; // Physical pixels per logical pixel.
+};
+
+// Common interface for the non-traffic visual modes (see ModeVisualizer).
+//
+// A mode splits its frame into a static layer that only depends on size, scale, theme and
+// meter, rendered once into a cached image, and a dynamic layer drawn on top every frame.
+// The dynamic layer should stay cheap: fills and small blits, no per-frame paths or
+// gradients. Each mode declares the per-frame budget the render benchmark holds it to.
+class BeatModeRenderer
+{
+public:
+  virtual ~BeatModeRenderer() = default;
+
+  virtual VisualMode getMode() const noexcept = 0;
+
+  // Budget for one 1920x1080 frame on the software renderer, in ms
+  // (checked by VizBeatsRenderBench --check-budgets).
+  virtual double getFrameBudgetMs() const noexcept = 0;
+
+  // Called once per frame before painting; keeps any animation state the mode needs.
+  virtual void advance(const BeatFrameState& frame) { juce::ignoreUnused(frame); }
+
+  // True while something still moves with the transport stopped.
+  virtual bool isAnimating() const noexcept { return false; }
+
+  // Renders the cached layer. Modes may also rebuild their own sprites here.
+  virtual void paintStaticLayer(juce::Graphics& g, const BeatModeContext& context) = 0;
+
+  virtual void paintDynamicLayer(juce::Graphics& g, const BeatModeContext& context) const = 0;
+};
+
+// Returns nullptr for Traffic, which has its own visualizer.
+std::unique_ptr<BeatModeRenderer> createBeatModeRenderer(VisualMode mode);
+
+const char* getVisualModeName(VisualMode mode) noexcept;
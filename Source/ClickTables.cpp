@@ -0,0 +1,59 @@
+#include "ClickTables.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr double kClickLengthSeconds = 0.040;
+
+struct ClickShape
+{
+  float gain;
+  double freqStart;
+  double freqEnd;
+  double lengthFraction; // Of the full click length.
+};
+
+// Sine sweep with an exponential decay. Shorter clicks start part-way into the sweep and
+// envelope of a full-length one, as the original per-sample synthesis did.
+std::vector<float> renderClick(const ClickShape& shape, double sampleRate)
+{
+  const auto fullLength = juce::jmax(1, static_cast<int>(std::round(kClickLengthSeconds * sampleRate)));
+  const auto length = juce::jmax(1, static_cast<int>(fullLength * shape.lengthFraction));
+
+  std::vector<float> samples(static_cast<size_t>(length));
+  double phase = 0.0;
+
+  for (int i = 0; i < length; ++i)
+  {
+    const auto t = 1.0 - static_cast<double>(length - i) / static_cast<double>(fullLength);
+    const auto freq = shape.freqStart + (shape.freqEnd - shape.freqStart) * t;
+
+    const auto env = static_cast<float>(std::exp(-5.0 * t));
+    const auto tone = static_cast<float>(std::sin(phase));
+    samples[static_cast<size_t>(i)] = shape.gain * env * tone;
+
+    phase += juce::MathConstants<double>::twoPi * freq / sampleRate;
+  }
+
+  return samples;
+}
+} // namespace
+
+ClickTables::ClickTables(double rate)
+    : sampleRate(rate > 0.0 ? rate : 44100.0)
+{
+  constexpr float normalGain = 0.45f;
+
+  tables[static_cast<size_t>(Type::Normal)] = renderClick({ normalGain, 2200.0, 800.0, 1.0 }, sampleRate);
+  tables[static_cast<size_t>(Type::Accent)] = renderClick({ 0.60f, 2800.0, 1100.0, 1.0 }, sampleRate);
+
+  // Softer, shorter, higher-pitched click for subdivisions
+  tables[static_cast<size_t>(Type::Subdivision)] = renderClick({ normalGain * 0.35f, 3200.0, 1800.0, 0.6 }, sampleRate);
+
+  // Polyrhythm lanes: a short high tick, a woody mid and a low thump, all a little quieter
+  // than the beat so the main pulse stays on top.
+  tables[static_cast<size_t>(Type::LaneHigh)] = renderClick({ normalGain * 0.70f, 4400.0, 3000.0, 0.5 }, sampleRate);
+  tables[static_cast<size_t>(Type::LaneMid)] = renderClick({ normalGain * 0.75f, 1500.0, 1100.0, 0.7 }, sampleRate);
+  tables[static_cast<size_t>(Type::LaneLow)] = renderClick({ normalGain * 0.85f, 700.0, 420.0, 0.9 }, sampleRate);
+}
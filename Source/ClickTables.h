@@ -0,0 +1,45 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedAssetCache.h"
+
+#include <array>
+#include <vector>
+
+// The metronome click sounds, pre-rendered at unity volume for one sample rate.
+//
+// Built once per sample rate and shared (read-only) by every processor running at that rate,
+// so triggering a click on the audio thread is a table read instead of per-sample sin/exp.
+class ClickTables
+{
+public:
+  enum class Type
+  {
+    Normal = 0,
+    Accent,
+    Subdivision,
+    LaneHigh, // polyrhythm lane voices, see getLaneVoice()
+    LaneMid,
+    LaneLow,
+    numTypes
+  };
+
+  static constexpr int numLaneVoices = 3;
+
+  explicit ClickTables(double sampleRate);
+
+  double getSampleRate() const noexcept { return sampleRate; }
+  const std::vector<float>& get(Type type) const noexcept { return tables[static_cast<size_t>(type)]; }
+
+  // Voices for polyrhythm lanes, pitched apart from the beat clicks and each other.
+  const std::vector<float>& getLaneVoice(int voice) const noexcept
+  {
+    return get(static_cast<Type>(static_cast<int>(Type::LaneHigh) + juce::jlimit(0, numLaneVoices - 1, voice)));
+  }
+
+private:
+  double sampleRate;
+  std::array<std::vector<float>, static_cast<size_t>(Type::numTypes)> tables;
+};
+
+using ClickTableCache = SharedAssetCache<double, ClickTables>;
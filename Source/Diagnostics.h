@@ -0,0 +1,21 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Where exported diagnostics (stats, logs, traces) are written.
+inline juce::File getDiagnosticsDirectory()
+{
+  return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+      .getChildFile("VizBeats")
+      .getChildFile("Diagnostics");
+}
+
+// A fresh file in the diagnostics directory, e.g. "frame-stats-20240131-142501.csv".
+inline juce::File makeDiagnosticsFile(const juce::String& prefix, const juce::String& extension)
+{
+  auto dir = getDiagnosticsDirectory();
+  dir.createDirectory();
+
+  const auto stamp = juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S");
+  return dir.getNonexistentChildFile(prefix + "-" + stamp, extension, false);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <cstddef>
+
+// Fixed-capacity FIFO stored inline. Elements are kept in insertion order, so when they are
+// pushed in time order the oldest is always at the front and expiry is a pop from the head.
+// Pushing onto a full buffer drops the oldest element; nothing ever allocates.
+template <typename T, std::size_t Capacity>
+class FixedRingBuffer
+{
+public:
+  static_assert(Capacity > 0, "FixedRingBuffer needs a non-zero capacity");
+
+  static constexpr std::size_t capacity() noexcept { return Capacity; }
+  std::size_t size() const noexcept { return count; }
+  bool isEmpty() const noexcept { return count == 0; }
+  bool isFull() const noexcept { return count == Capacity; }
+
+  void push(const T& item) noexcept
+  {
+    if (isFull())
+      popFront();
+
+    items[(head + count) % Capacity] = item;
+    ++count;
+  }
+
+  const T& front() const noexcept
+  {
+    jassert(!isEmpty());
+    return items[head];
+  }
+
+  void popFront() noexcept
+  {
+    jassert(!isEmpty());
+    head = (head + 1) % Capacity;
+    --count;
+  }
+
+  void clear() noexcept
+  {
+    head = 0;
+    count = 0;
+  }
+
+  // Oldest element is index 0.
+  const T& operator[](std::size_t index) const noexcept
+  {
+    jassert(index < count);
+    return items[(head + index) % Capacity];
+  }
+
+private:
+  std::array<T, Capacity> items {};
+  std::size_t head = 0;
+  std::size_t count = 0;
+};
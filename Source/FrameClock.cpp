@@ -0,0 +1,143 @@
+#include "FrameClock.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+
+namespace
+{
+// How often the clock checks that its driver is still delivering vblanks.
+constexpr int kDriverCheckIntervalMs = 250;
+
+// A driver that has not ticked for this long is replaced by another showing editor.
+constexpr double kDriverStallSeconds = 0.2;
+
+double getNowSeconds()
+{
+  return juce::Time::getMillisecondCounterHiRes() * 0.001;
+}
+} // namespace
+
+FrameClock::FrameClock() = default;
+
+FrameClock::~FrameClock()
+{
+  jassert(entries.empty()); // Clients must unregister before the last pointer goes away.
+  attachment.reset();
+}
+
+void FrameClock::addClient(Client& client, juce::Component& component)
+{
+  JUCE_ASSERT_MESSAGE_THREAD
+
+  entries.push_back({ &client, &component });
+
+  if (driver == nullptr)
+    selectDriver(false);
+
+  if (!isTimerRunning())
+    startTimer(kDriverCheckIntervalMs);
+}
+
+void FrameClock::removeClient(Client& client)
+{
+  JUCE_ASSERT_MESSAGE_THREAD
+
+  juce::Component* removedComponent = nullptr;
+
+  for (auto& entry : entries)
+  {
+    if (entry.client == &client)
+    {
+      removedComponent = entry.component;
+      entry.client = nullptr; // Erased below, or after the tick in progress.
+      entry.component = nullptr;
+    }
+  }
+
+  if (!ticking)
+    removeDeadEntries();
+
+  if (removedComponent != nullptr && removedComponent == driver)
+    selectDriver(false);
+
+  if (entries.empty())
+    stopTimer();
+}
+
+void FrameClock::tick()
+{
+  const ScopedTrace trace("FrameClock::tick");
+  const auto nowSeconds = getNowSeconds();
+  lastTickSeconds = nowSeconds;
+
+  // Index loop: a client may unregister (itself or another) while being ticked.
+  ticking = true;
+  for (size_t i = 0; i < entries.size(); ++i)
+    if (auto* client = entries[i].client)
+      client->frameClockTick(nowSeconds);
+  ticking = false;
+
+  removeDeadEntries();
+}
+
+void FrameClock::selectDriver(bool avoidCurrent)
+{
+  juce::Component* newDriver = nullptr;
+
+  for (const auto& entry : entries)
+  {
+    if (entry.component == nullptr || !entry.component->isShowing())
+      continue;
+
+    if (avoidCurrent && entry.component == driver)
+      continue;
+
+    newDriver = entry.component;
+    break;
+  }
+
+  // Nothing better available: keep the current driver.
+  if (newDriver == nullptr && avoidCurrent)
+    return;
+
+  // Nothing showing yet (e.g. an editor that is still being opened): attach to the first
+  // client anyway, the attachment starts delivering once its window appears.
+  if (newDriver == nullptr)
+  {
+    for (const auto& entry : entries)
+    {
+      if (entry.component != nullptr)
+      {
+        newDriver = entry.component;
+        break;
+      }
+    }
+  }
+
+  if (newDriver == driver && attachment != nullptr)
+    return;
+
+  attachment.reset();
+  driver = newDriver;
+
+  if (driver != nullptr)
+    attachment = std::make_unique<juce::VBlankAttachment>(driver, [this] { tick(); });
+}
+
+void FrameClock::removeDeadEntries()
+{
+  entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry& e) { return e.client == nullptr; }),
+                entries.end());
+}
+
+void FrameClock::timerCallback()
+{
+  const ScopedTrace trace("FrameClock::timerCallback");
+  // Vblanks stop when the driver is hidden, minimised or occluded; hand over to another
+  // showing editor so the others keep animating.
+  const bool driverShowing = driver != nullptr && driver->isShowing();
+  if (!driverShowing)
+    selectDriver(false);
+  else if (getNowSeconds() - lastTickSeconds > kDriverStallSeconds)
+    selectDriver(true);
+}
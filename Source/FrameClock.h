@@ -0,0 +1,55 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <memory>
+#include <vector>
+
+// One vblank-aligned frame tick shared by every open editor in the process.
+//
+// Editors register through a juce::SharedResourcePointer<FrameClock>. A single VBlankAttachment
+// on one showing editor (the driver) triggers one batched callback that ticks every client with
+// the same timestamp, so N open editors cost one callback and one repaint burst per refresh
+// instead of N unsynchronised ones. If the driver is closed, hidden or stops receiving vblanks,
+// the clock moves to another showing editor.
+class FrameClock final : private juce::Timer
+{
+public:
+  class Client
+  {
+  public:
+    virtual ~Client() = default;
+
+    // Called on the message thread once per display refresh.
+    virtual void frameClockTick(double nowSeconds) = 0;
+  };
+
+  FrameClock();
+  ~FrameClock() override;
+
+  // `component` is the client's on-screen component; it may be picked to drive the clock.
+  void addClient(Client& client, juce::Component& component);
+  void removeClient(Client& client);
+
+  int getNumClients() const noexcept { return static_cast<int>(entries.size()); }
+
+private:
+  struct Entry
+  {
+    Client* client = nullptr;
+    juce::Component* component = nullptr;
+  };
+
+  void tick();
+  void selectDriver(bool avoidCurrent);
+  void removeDeadEntries();
+  void timerCallback() override;
+
+  std::vector<Entry> entries;
+  juce::Component* driver = nullptr;
+  std::unique_ptr<juce::VBlankAttachment> attachment;
+  double lastTickSeconds = 0.0;
+  bool ticking = false;
+
+  JUCE_DECLARE_NON_COPYABLE(FrameClock)
+};
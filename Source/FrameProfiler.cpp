@@ -0,0 +1,183 @@
+#include "FrameProfiler.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr double kFirstBinSeconds = 10.0e-6;
+constexpr double kBinGrowth = 1.2;
+
+// An interval this much longer than the refresh period counts as a late callback.
+constexpr double kLateFactor = 1.5;
+}
+
+//==============================================================================
+void DurationHistogram::record(double seconds) noexcept
+{
+  if (!(seconds >= 0.0))
+    return;
+
+  int bin = 0;
+  if (seconds > kFirstBinSeconds)
+    bin = static_cast<int>(std::ceil(std::log(seconds / kFirstBinSeconds) / std::log(kBinGrowth)));
+
+  bin = juce::jlimit(0, numBins - 1, bin);
+  counts[static_cast<size_t>(bin)].fetch_add(1, std::memory_order_relaxed);
+
+  auto prevMax = maxSeconds.load(std::memory_order_relaxed);
+  while (seconds > prevMax && !maxSeconds.compare_exchange_weak(prevMax, seconds, std::memory_order_relaxed))
+  {
+  }
+}
+
+void DurationHistogram::reset() noexcept
+{
+  for (auto& c : counts)
+    c.store(0, std::memory_order_relaxed);
+
+  maxSeconds.store(0.0, std::memory_order_relaxed);
+}
+
+DurationHistogram::Snapshot DurationHistogram::snapshot() const noexcept
+{
+  Snapshot s;
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    s.counts[i] = counts[i].load(std::memory_order_relaxed);
+    s.total += s.counts[i];
+  }
+
+  s.maxSeconds = maxSeconds.load(std::memory_order_relaxed);
+  return s;
+}
+
+double DurationHistogram::getBinUpperBoundSeconds(int bin) noexcept
+{
+  return kFirstBinSeconds * std::pow(kBinGrowth, static_cast<double>(bin));
+}
+
+double DurationHistogram::Snapshot::percentile(double p) const noexcept
+{
+  if (total == 0)
+    return 0.0;
+
+  const auto target = static_cast<juce::uint64>(std::ceil(juce::jlimit(0.0, 1.0, p) * static_cast<double>(total)));
+  juce::uint64 seen = 0;
+
+  for (int i = 0; i < numBins; ++i)
+  {
+    seen += counts[static_cast<size_t>(i)];
+    if (seen >= target && seen > 0)
+      return juce::jmin(getBinUpperBoundSeconds(i), maxSeconds);
+  }
+
+  return maxSeconds;
+}
+
+//==============================================================================
+const char* FrameProfiler::getChannelName(Channel channel) noexcept
+{
+  switch (channel)
+  {
+    case Channel::FrameCallback: return "frame_callback";
+    case Channel::FrameInterval: return "frame_interval";
+    case Channel::TrafficPaint: return "traffic_paint";
+    case Channel::ModePaint: return "mode_paint";
+    case Channel::numChannels:
+    default: break;
+  }
+
+  return "unknown";
+}
+
+void FrameProfiler::record(Channel channel, double seconds) noexcept
+{
+  histograms[static_cast<size_t>(channel)].record(seconds);
+}
+
+void FrameProfiler::recordFrameInterval(double seconds) noexcept
+{
+  record(Channel::FrameInterval, seconds);
+
+  // Follow the display refresh with a slow average over intervals that look on time.
+  if (seconds > 0.0 && seconds < refreshPeriodSeconds * 1.25)
+    refreshPeriodSeconds += (seconds - refreshPeriodSeconds) * 0.05;
+
+  if (seconds > refreshPeriodSeconds * kLateFactor)
+  {
+    lateCallbacks.fetch_add(1, std::memory_order_relaxed);
+
+    const auto missed = static_cast<juce::int64>(std::round(seconds / refreshPeriodSeconds)) - 1;
+    if (missed > 0)
+      droppedFrames.fetch_add(static_cast<juce::uint64>(missed), std::memory_order_relaxed);
+  }
+}
+
+void FrameProfiler::reset() noexcept
+{
+  for (auto& h : histograms)
+    h.reset();
+
+  droppedFrames.store(0, std::memory_order_relaxed);
+  lateCallbacks.store(0, std::memory_order_relaxed);
+}
+
+FrameProfiler::ChannelStats FrameProfiler::getStats(Channel channel) const noexcept
+{
+  const auto snap = histograms[static_cast<size_t>(channel)].snapshot();
+
+  ChannelStats stats;
+  stats.count = snap.total;
+  stats.p50Ms = snap.percentile(0.50) * 1000.0;
+  stats.p95Ms = snap.percentile(0.95) * 1000.0;
+  stats.p99Ms = snap.percentile(0.99) * 1000.0;
+  stats.maxMs = snap.maxSeconds * 1000.0;
+  return stats;
+}
+
+juce::String FrameProfiler::toCsv() const
+{
+  juce::String csv;
+  csv << "channel,count,p50_ms,p95_ms,p99_ms,max_ms\n";
+
+  for (int c = 0; c < static_cast<int>(Channel::numChannels); ++c)
+  {
+    const auto channel = static_cast<Channel>(c);
+    const auto stats = getStats(channel);
+    csv << getChannelName(channel) << ','
+        << juce::String(static_cast<juce::int64>(stats.count)) << ','
+        << juce::String(stats.p50Ms, 3) << ','
+        << juce::String(stats.p95Ms, 3) << ','
+        << juce::String(stats.p99Ms, 3) << ','
+        << juce::String(stats.maxMs, 3) << '\n';
+  }
+
+  csv << "\ndropped_frames," << juce::String(static_cast<juce::int64>(getDroppedFrames())) << '\n';
+  csv << "late_callbacks," << juce::String(static_cast<juce::int64>(getLateCallbacks())) << '\n';
+  csv << "refresh_period_ms," << juce::String(refreshPeriodSeconds * 1000.0, 3) << '\n';
+
+  csv << "\nchannel,bin_upper_ms,count\n";
+  for (int c = 0; c < static_cast<int>(Channel::numChannels); ++c)
+  {
+    const auto channel = static_cast<Channel>(c);
+    const auto snap = histograms[static_cast<size_t>(c)].snapshot();
+
+    for (int i = 0; i < DurationHistogram::numBins; ++i)
+    {
+      const auto count = snap.counts[static_cast<size_t>(i)];
+      if (count == 0)
+        continue;
+
+      csv << getChannelName(channel) << ','
+          << juce::String(DurationHistogram::getBinUpperBoundSeconds(i) * 1000.0, 4) << ','
+          << juce::String(static_cast<juce::int64>(count)) << '\n';
+    }
+  }
+
+  return csv;
+}
+
+bool FrameProfiler::writeCsv(const juce::File& file) const
+{
+  return file.replaceWithText(toCsv());
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+
+// Lock-free histogram of durations. Bins are log-spaced from 10 us up to ~1 s, so recording
+// is a single relaxed atomic increment and can happen from any thread.
+class DurationHistogram
+{
+public:
+  static constexpr int numBins = 64;
+
+  void record(double seconds) noexcept;
+  void reset() noexcept;
+
+  struct Snapshot
+  {
+    std::array<juce::uint32, numBins> counts {};
+    juce::uint64 total = 0;
+    double maxSeconds = 0.0;
+
+    // Upper bound of the bin containing the given percentile (0..1), in seconds.
+    double percentile(double p) const noexcept;
+  };
+
+  Snapshot snapshot() const noexcept;
+
+  static double getBinUpperBoundSeconds(int bin) noexcept;
+
+private:
+  std::array<std::atomic<juce::uint32>, numBins> counts {};
+  std::atomic<double> maxSeconds { 0.0 };
+};
+
+// Per-editor frame timing: frame callback duration, visualizer paint durations and
+// frame-to-frame interval, plus dropped-frame and late-callback counters.
+class FrameProfiler
+{
+public:
+  enum class Channel
+  {
+    FrameCallback = 0,
+    FrameInterval,
+    TrafficPaint,
+    ModePaint, // Any non-traffic visual mode.
+    numChannels
+  };
+
+  static const char* getChannelName(Channel channel) noexcept;
+
+  void record(Channel channel, double seconds) noexcept;
+
+  // Records the time between two consecutive active frames. Called from the message thread
+  // only; it also tracks the display refresh period to classify late and dropped frames.
+  void recordFrameInterval(double seconds) noexcept;
+
+  void reset() noexcept;
+
+  struct ChannelStats
+  {
+    juce::uint64 count = 0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+  };
+
+  ChannelStats getStats(Channel channel) const noexcept;
+  juce::uint64 getDroppedFrames() const noexcept { return droppedFrames.load(std::memory_order_relaxed); }
+  juce::uint64 getLateCallbacks() const noexcept { return lateCallbacks.load(std::memory_order_relaxed); }
+  double getRefreshPeriodSeconds() const noexcept { return refreshPeriodSeconds; }
+
+  juce::String toCsv() const;
+  bool writeCsv(const juce::File& file) const;
+
+  // Times a scope into a channel; a null profiler makes it a no-op.
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer(FrameProfiler* p, Channel c) noexcept
+        : profiler(p), channel(c), startTicks(p != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+    {
+    }
+
+    ~ScopedTimer()
+    {
+      if (profiler != nullptr)
+        profiler->record(channel, juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+    }
+
+  private:
+    FrameProfiler* profiler;
+    Channel channel;
+    juce::int64 startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+  };
+
+private:
+  std::array<DurationHistogram, static_cast<size_t>(Channel::numChannels)> histograms;
+  std::atomic<juce::uint64> droppedFrames { 0 };
+  std::atomic<juce::uint64> lateCallbacks { 0 };
+  double refreshPeriodSeconds = 1.0 / 60.0;
+};
@@ -0,0 +1,101 @@
+#include "GlyphCache.h"
+
+#include <cmath>
+
+GlyphCache::GlyphCache(const char* characterSet)
+    : characters(characterSet)
+{
+}
+
+GlyphCache::Key GlyphCache::makeKey(const char* characterSet, float fontHeight, bool bold, float physicalScale)
+{
+  return { characterSet, fontHeight, bold, juce::jlimit(0.5f, 4.0f, physicalScale) };
+}
+
+bool GlyphCache::matches(const char* characterSet, float fontHeight, bool bold, float physicalScale) const noexcept
+{
+  return height == fontHeight && isBold == bold && scale == juce::jlimit(0.5f, 4.0f, physicalScale) && characters == characterSet;
+}
+
+bool GlyphCache::prepare(float fontHeight, bool bold, float physicalScale)
+{
+  const auto newScale = juce::jlimit(0.5f, 4.0f, physicalScale);
+  if (fontHeight == height && bold == isBold && newScale == scale)
+    return false;
+
+  height = fontHeight;
+  isBold = bold;
+  scale = newScale;
+
+  // Glyph outlines can overhang their advance slightly; keep a margin so nothing is clipped.
+  padding = std::ceil(height * 0.15f);
+
+  const juce::Font font(height, bold ? juce::Font::bold : juce::Font::plain);
+
+  for (auto& glyph : glyphs)
+    glyph = {};
+
+  for (const auto c : characters)
+  {
+    if (c == 0 || static_cast<size_t>(c) >= glyphs.size())
+      continue;
+
+    const auto text = juce::String::charToString(c);
+    auto& glyph = glyphs[static_cast<size_t>(c)];
+    glyph.advance = juce::GlyphArrangement::getStringWidth(font, text);
+
+    const auto w = juce::jmax(1, static_cast<int>(std::ceil((glyph.advance + padding * 2.0f) * scale)));
+    const auto h = juce::jmax(1, static_cast<int>(std::ceil(height * scale)));
+    glyph.mask = juce::Image(juce::Image::SingleChannel, w, h, true, juce::SoftwareImageType());
+
+    juce::Graphics g(glyph.mask);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    g.setColour(juce::Colours::white);
+    g.setFont(font);
+    g.drawText(text, juce::Rectangle<float>(padding, 0.0f, glyph.advance + padding, height), juce::Justification::centredLeft, false);
+  }
+
+  return true;
+}
+
+const GlyphCache::Glyph* GlyphCache::getGlyph(char c) const noexcept
+{
+  if (c <= 0 || static_cast<size_t>(c) >= glyphs.size())
+    return nullptr;
+
+  const auto& glyph = glyphs[static_cast<size_t>(c)];
+  return glyph.mask.isValid() ? &glyph : nullptr;
+}
+
+float GlyphCache::getTextWidth(const char* text) const noexcept
+{
+  float width = 0.0f;
+
+  for (auto* p = text; *p != 0; ++p)
+    if (const auto* glyph = getGlyph(*p))
+      width += glyph->advance;
+
+  return width;
+}
+
+void GlyphCache::drawText(juce::Graphics& g, const char* text, juce::Rectangle<float> area, juce::Justification justification) const
+{
+  if (scale <= 0.0f)
+    return;
+
+  const auto placed = justification.appliedToRectangle(juce::Rectangle<float>(getTextWidth(text), height), area);
+
+  // Snap to the physical pixel grid so each blit stays an untransformed copy.
+  auto x = std::round((placed.getX() - padding) * scale) / scale;
+  const auto y = std::round(placed.getY() * scale) / scale;
+
+  for (auto* p = text; *p != 0; ++p)
+  {
+    const auto* glyph = getGlyph(*p);
+    if (glyph == nullptr)
+      continue;
+
+    g.drawImageTransformed(glyph->mask, juce::AffineTransform::scale(1.0f / scale).translated(x, y), true);
+    x += std::round(glyph->advance * scale) / scale;
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedAssetCache.h"
+
+#include <array>
+
+// Pre-rendered glyph masks for short readouts that repaint often (BPM digits, bar/beat
+// counter).
+//
+// Each character of a fixed ASCII set is rasterised once per font height, weight and
+// physical pixel scale as an alpha mask. Drawing tints the masks with the current colour,
+// so updating a readout is a few image blits instead of font lookup and text shaping.
+// Prepared caches are shared between editors through GlyphCacheSet.
+class GlyphCache
+{
+public:
+  struct Key
+  {
+    juce::String characters;
+    float height = 0.0f;
+    bool bold = false;
+    float scale = 0.0f;
+
+    bool operator==(const Key& other) const noexcept
+    {
+      return height == other.height && bold == other.bold && scale == other.scale && characters == other.characters;
+    }
+  };
+
+  explicit GlyphCache(const char* characterSet);
+
+  static Key makeKey(const char* characterSet, float fontHeight, bool bold, float physicalScale);
+
+  // Allocation-free check for whether this cache was prepared with these settings.
+  bool matches(const char* characterSet, float fontHeight, bool bold, float physicalScale) const noexcept;
+
+  // Re-rasterises the glyphs if the font or scale changed; returns true if it did.
+  bool prepare(float fontHeight, bool bold, float physicalScale);
+
+  float getTextWidth(const char* text) const noexcept;
+
+  // Draws ASCII text in the current colour. Characters outside the set are skipped.
+  void drawText(juce::Graphics& g, const char* text, juce::Rectangle<float> area, juce::Justification justification) const;
+
+private:
+  struct Glyph
+  {
+    juce::Image mask;
+    float advance = 0.0f;
+  };
+
+  const Glyph* getGlyph(char c) const noexcept;
+
+  juce::String characters;
+  std::array<Glyph, 128> glyphs;
+
+  float height = 0.0f;
+  bool isBold = false;
+  float scale = 0.0f;
+  float padding = 0.0f;
+};
+
+using GlyphCacheSet = SharedAssetCache<GlyphCache::Key, GlyphCache>;
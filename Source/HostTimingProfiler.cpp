@@ -0,0 +1,303 @@
+#include "HostTimingProfiler.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr int kSmallestBlockSizeBin = 32;
+
+// Callback gaps longer than this are pauses (host idle, offline bounce), not jitter.
+constexpr double kMaxCallbackIntervalSeconds = 1.0;
+
+int getBlockSizeBin(int numSamples) noexcept
+{
+  int bin = 0;
+  for (int upper = kSmallestBlockSizeBin; numSamples > upper && bin < HostTimingProfiler::numBlockSizeBins - 1; upper *= 2)
+    ++bin;
+
+  return bin;
+}
+
+double toPercent(juce::uint64 count, juce::uint64 total) noexcept
+{
+  return total > 0 ? 100.0 * static_cast<double>(count) / static_cast<double>(total) : 0.0;
+}
+
+juce::String toString(juce::uint64 count)
+{
+  return juce::String(static_cast<juce::int64>(count));
+}
+} // namespace
+
+const char* HostTimingProfiler::getFieldName(Field field) noexcept
+{
+  switch (field)
+  {
+    case Field::Bpm: return "bpm";
+    case Field::TimeSignature: return "time_signature";
+    case Field::PpqPosition: return "ppq";
+    case Field::BarStartPpq: return "bar_start_ppq";
+    case Field::TimeInSeconds: return "time_seconds";
+    case Field::TimeInSamples: return "time_samples";
+    case Field::LoopPoints: return "loop_points";
+    case Field::BarCount: return "bar_count";
+    case Field::HostTimeNs: return "host_time_ns";
+    case Field::numFields: break;
+  }
+
+  return "unknown";
+}
+
+juce::String HostTimingProfiler::getBlockSizeBinLabel(int bin)
+{
+  if (bin >= numBlockSizeBins - 1)
+    return ">" + juce::String(kSmallestBlockSizeBin << (numBlockSizeBins - 2));
+
+  return (bin == 0 ? "<=" : "") + juce::String(kSmallestBlockSizeBin << bin);
+}
+
+//==============================================================================
+void HostTimingProfiler::recordPrepare() noexcept
+{
+  lastCallbackTicks = 0;
+  lastBlockSize = 0;
+}
+
+void HostTimingProfiler::recordBlock(const juce::AudioPlayHead::PositionInfo* position, int numSamples, double sampleRate) noexcept
+{
+  const auto nowTicks = juce::Time::getHighResolutionTicks();
+
+  // Interval since the previous callback against the audio that block represented.
+  if (lastCallbackTicks != 0)
+  {
+    const auto interval = juce::Time::highResolutionTicksToSeconds(nowTicks - lastCallbackTicks);
+    if (interval < kMaxCallbackIntervalSeconds)
+    {
+      callbackIntervals.record(interval);
+      callbackJitter.record(std::abs(interval - lastBlockSeconds));
+    }
+  }
+
+  lastCallbackTicks = nowTicks;
+  lastBlockSeconds = sampleRate > 0.0 ? static_cast<double>(numSamples) / sampleRate : 0.0;
+
+  increment(blocks);
+  increment(blockSizeCounts[static_cast<size_t>(getBlockSizeBin(numSamples))]);
+
+  if (lastBlockSize != 0 && numSamples != lastBlockSize)
+    increment(blockSizeChanges);
+  lastBlockSize = numSamples;
+
+  // Only this thread writes the extremes; reset() may zero them concurrently.
+  const auto currentMin = minBlockSize.load(std::memory_order_relaxed);
+  if (currentMin == 0 || numSamples < currentMin)
+    minBlockSize.store(numSamples, std::memory_order_relaxed);
+  if (numSamples > maxBlockSize.load(std::memory_order_relaxed))
+    maxBlockSize.store(numSamples, std::memory_order_relaxed);
+
+  if (position == nullptr)
+  {
+    increment(blocksWithoutPosition);
+    return;
+  }
+
+  const bool playing = position->getIsPlaying();
+  if (playing)
+    increment(playingBlocks);
+
+  const auto countField = [this, playing](Field field, bool present)
+  {
+    if (!present)
+      return;
+
+    increment(fieldCounts[static_cast<size_t>(field)]);
+    if (playing)
+      increment(playingFieldCounts[static_cast<size_t>(field)]);
+  };
+
+  countField(Field::Bpm, position->getBpm().hasValue());
+  countField(Field::TimeSignature, position->getTimeSignature().hasValue());
+  countField(Field::PpqPosition, position->getPpqPosition().hasValue());
+  countField(Field::BarStartPpq, position->getPpqPositionOfLastBarStart().hasValue());
+  countField(Field::TimeInSeconds, position->getTimeInSeconds().hasValue());
+  countField(Field::TimeInSamples, position->getTimeInSamples().hasValue());
+  countField(Field::LoopPoints, position->getLoopPoints().hasValue());
+  countField(Field::BarCount, position->getBarCount().hasValue());
+  countField(Field::HostTimeNs, position->getHostTimeNs().hasValue());
+}
+
+void HostTimingProfiler::recordPhaseSource(BeatPhaseSource source) noexcept
+{
+  increment(phaseSourceCounts[static_cast<size_t>(source)]);
+}
+
+void HostTimingProfiler::recordPpqError(double errorSeconds, bool isJump) noexcept
+{
+  if (isJump)
+    increment(ppqJumps);
+  else
+    ppqErrors.record(std::abs(errorSeconds));
+}
+
+void HostTimingProfiler::reset() noexcept
+{
+  for (auto* counter : { &blocks, &playingBlocks, &blocksWithoutPosition, &blockSizeChanges, &ppqJumps })
+    counter->store(0, std::memory_order_relaxed);
+
+  for (auto& c : fieldCounts)
+    c.store(0, std::memory_order_relaxed);
+  for (auto& c : playingFieldCounts)
+    c.store(0, std::memory_order_relaxed);
+  for (auto& c : blockSizeCounts)
+    c.store(0, std::memory_order_relaxed);
+  for (auto& c : phaseSourceCounts)
+    c.store(0, std::memory_order_relaxed);
+
+  minBlockSize.store(0, std::memory_order_relaxed);
+  maxBlockSize.store(0, std::memory_order_relaxed);
+
+  callbackIntervals.reset();
+  callbackJitter.reset();
+  ppqErrors.reset();
+}
+
+HostTimingProfiler::Report HostTimingProfiler::getReport() const noexcept
+{
+  const auto load = [](const Counter& c) { return c.load(std::memory_order_relaxed); };
+
+  Report r;
+  r.blocks = load(blocks);
+  r.playingBlocks = load(playingBlocks);
+  r.blocksWithoutPosition = load(blocksWithoutPosition);
+  r.blockSizeChanges = load(blockSizeChanges);
+  r.minBlockSize = minBlockSize.load(std::memory_order_relaxed);
+  r.maxBlockSize = maxBlockSize.load(std::memory_order_relaxed);
+
+  for (size_t i = 0; i < r.fieldCounts.size(); ++i)
+  {
+    r.fieldCounts[i] = load(fieldCounts[i]);
+    r.playingFieldCounts[i] = load(playingFieldCounts[i]);
+  }
+
+  for (size_t i = 0; i < r.blockSizeCounts.size(); ++i)
+    r.blockSizeCounts[i] = load(blockSizeCounts[i]);
+
+  for (size_t i = 0; i < r.phaseSourceCounts.size(); ++i)
+    r.phaseSourceCounts[i] = load(phaseSourceCounts[i]);
+
+  r.callbackIntervals = callbackIntervals.snapshot();
+  r.callbackJitter = callbackJitter.snapshot();
+  r.ppqErrors = ppqErrors.snapshot();
+  r.ppqJumps = load(ppqJumps);
+  return r;
+}
+
+juce::StringArray HostTimingProfiler::getSummaryLines() const
+{
+  const auto r = getReport();
+  juce::StringArray lines;
+
+  lines.add("blocks " + toString(r.blocks) + "  playing " + juce::String(toPercent(r.playingBlocks, r.blocks), 0) + "%");
+  lines.add("size " + juce::String(r.minBlockSize) + ".." + juce::String(r.maxBlockSize)
+            + "  changes " + toString(r.blockSizeChanges));
+
+  // Fields the host supplies in most playing blocks.
+  juce::String fields("fields");
+  for (size_t i = 0; i < r.playingFieldCounts.size(); ++i)
+  {
+    if (r.playingBlocks > 0 && r.playingFieldCounts[i] * 2 > r.playingBlocks)
+    {
+      switch (static_cast<Field>(i))
+      {
+        case Field::Bpm: fields << " bpm"; break;
+        case Field::TimeSignature: fields << " sig"; break;
+        case Field::PpqPosition: fields << " ppq"; break;
+        case Field::BarStartPpq: fields << " bar"; break;
+        case Field::TimeInSeconds: fields << " sec"; break;
+        case Field::TimeInSamples: fields << " smp"; break;
+        case Field::LoopPoints: fields << " loop"; break;
+        case Field::BarCount: fields << " bars"; break;
+        case Field::HostTimeNs: fields << " ns"; break;
+        case Field::numFields: break;
+      }
+    }
+  }
+  lines.add(r.playingBlocks > 0 ? fields : juce::String("fields (not played yet)"));
+
+  lines.add("cb jitter p50 " + juce::String(r.callbackJitter.percentile(0.50) * 1000.0, 2)
+            + " p99 " + juce::String(r.callbackJitter.percentile(0.99) * 1000.0, 2) + " ms");
+  lines.add("ppq err p99 " + juce::String(r.ppqErrors.percentile(0.99) * 1000.0, 2)
+            + " ms  jumps " + toString(r.ppqJumps));
+
+  // Share of running blocks per source (BeatPhaseSource::None is stopped).
+  juce::uint64 runningTotal = 0;
+  for (size_t i = 1; i < r.phaseSourceCounts.size(); ++i)
+    runningTotal += r.phaseSourceCounts[i];
+
+  const auto sourcePercent = [&r, runningTotal](BeatPhaseSource s)
+  {
+    return juce::String(toPercent(r.phaseSourceCounts[static_cast<size_t>(s)], runningTotal), 0);
+  };
+
+  lines.add("src% ppq" + sourcePercent(BeatPhaseSource::HostPpq)
+            + " sec" + sourcePercent(BeatPhaseSource::HostSeconds)
+            + " smp" + sourcePercent(BeatPhaseSource::HostSamples)
+            + " fb" + sourcePercent(BeatPhaseSource::HostFallback)
+            + " int" + sourcePercent(BeatPhaseSource::Internal)
+            + " map" + sourcePercent(BeatPhaseSource::TempoMap));
+
+  return lines;
+}
+
+juce::String HostTimingProfiler::toCsv() const
+{
+  const auto r = getReport();
+  juce::String csv;
+
+  csv << "host," << juce::PluginHostType().getHostDescription() << '\n';
+  csv << "blocks," << toString(r.blocks) << '\n';
+  csv << "playing_blocks," << toString(r.playingBlocks) << '\n';
+  csv << "blocks_without_position," << toString(r.blocksWithoutPosition) << '\n';
+  csv << "min_block_size," << r.minBlockSize << '\n';
+  csv << "max_block_size," << r.maxBlockSize << '\n';
+  csv << "block_size_changes," << toString(r.blockSizeChanges) << '\n';
+
+  csv << "\nfield,blocks_present,playing_blocks_present,playing_percent\n";
+  for (int i = 0; i < static_cast<int>(Field::numFields); ++i)
+  {
+    const auto index = static_cast<size_t>(i);
+    csv << getFieldName(static_cast<Field>(i)) << ','
+        << toString(r.fieldCounts[index]) << ','
+        << toString(r.playingFieldCounts[index]) << ','
+        << juce::String(toPercent(r.playingFieldCounts[index], r.playingBlocks), 1) << '\n';
+  }
+
+  csv << "\nblock_size,count\n";
+  for (int i = 0; i < numBlockSizeBins; ++i)
+    csv << getBlockSizeBinLabel(i) << ',' << toString(r.blockSizeCounts[static_cast<size_t>(i)]) << '\n';
+
+  csv << "\nphase_source,blocks\n";
+  for (int i = 0; i < static_cast<int>(BeatPhaseSource::numSources); ++i)
+    csv << getBeatPhaseSourceName(static_cast<BeatPhaseSource>(i)) << ',' << toString(r.phaseSourceCounts[static_cast<size_t>(i)]) << '\n';
+
+  csv << "\nmetric,count,p50_ms,p95_ms,p99_ms,max_ms\n";
+  const auto addMetric = [&csv](const char* name, const DurationHistogram::Snapshot& snap)
+  {
+    csv << name << ',' << toString(snap.total) << ','
+        << juce::String(snap.percentile(0.50) * 1000.0, 4) << ','
+        << juce::String(snap.percentile(0.95) * 1000.0, 4) << ','
+        << juce::String(snap.percentile(0.99) * 1000.0, 4) << ','
+        << juce::String(snap.maxSeconds * 1000.0, 4) << '\n';
+  };
+  addMetric("callback_interval", r.callbackIntervals);
+  addMetric("callback_jitter", r.callbackJitter);
+  addMetric("ppq_error", r.ppqErrors);
+  csv << "ppq_jumps," << toString(r.ppqJumps) << '\n';
+
+  return csv;
+}
+
+bool HostTimingProfiler::writeCsv(const juce::File& file) const
+{
+  return file.replaceWithText(toCsv());
+}
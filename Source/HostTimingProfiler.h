@@ -0,0 +1,100 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "FrameProfiler.h"
+#include "RtLog.h"
+
+#include <array>
+#include <atomic>
+
+// Per-instance record of what the host actually delivers to processBlock(): which PositionInfo
+// fields are present, block sizes, audio callback interval jitter, PPQ error against the
+// position predicted from the previous block, and which computeBeatPhase() branch ran.
+//
+// The record* calls are made on the audio thread and are relaxed atomic increments only; the
+// editor reads a snapshot on the message thread.
+class HostTimingProfiler
+{
+public:
+  enum class Field
+  {
+    Bpm = 0,
+    TimeSignature,
+    PpqPosition,
+    BarStartPpq,
+    TimeInSeconds,
+    TimeInSamples,
+    LoopPoints,
+    BarCount,
+    HostTimeNs,
+    numFields
+  };
+
+  static const char* getFieldName(Field field) noexcept;
+
+  // Power-of-two buckets: <=32, 64, 128, ..., 4096, larger.
+  static constexpr int numBlockSizeBins = 9;
+  static juce::String getBlockSizeBinLabel(int bin);
+
+  void recordPrepare() noexcept;
+  void recordBlock(const juce::AudioPlayHead::PositionInfo* position, int numSamples, double sampleRate) noexcept;
+  void recordPhaseSource(BeatPhaseSource source) noexcept;
+
+  // Reported minus predicted PPQ, in seconds at the current tempo. Jumps (loops, seeks) are
+  // counted separately so the error distribution only shows drift and jitter.
+  void recordPpqError(double errorSeconds, bool isJump) noexcept;
+
+  void reset() noexcept;
+
+  struct Report
+  {
+    juce::uint64 blocks = 0;
+    juce::uint64 playingBlocks = 0;
+    juce::uint64 blocksWithoutPosition = 0;
+    juce::uint64 blockSizeChanges = 0;
+    int minBlockSize = 0;
+    int maxBlockSize = 0;
+    std::array<juce::uint64, static_cast<size_t>(Field::numFields)> fieldCounts {};
+    std::array<juce::uint64, static_cast<size_t>(Field::numFields)> playingFieldCounts {};
+    std::array<juce::uint64, numBlockSizeBins> blockSizeCounts {};
+    std::array<juce::uint64, static_cast<size_t>(BeatPhaseSource::numSources)> phaseSourceCounts {};
+    DurationHistogram::Snapshot callbackIntervals;
+    DurationHistogram::Snapshot callbackJitter;
+    DurationHistogram::Snapshot ppqErrors;
+    juce::uint64 ppqJumps = 0;
+  };
+
+  Report getReport() const noexcept;
+
+  // A few short lines for the stats overlay.
+  juce::StringArray getSummaryLines() const;
+
+  juce::String toCsv() const;
+  bool writeCsv(const juce::File& file) const;
+
+private:
+  using Counter = std::atomic<juce::uint64>;
+
+  static void increment(Counter& counter) noexcept { counter.fetch_add(1, std::memory_order_relaxed); }
+
+  Counter blocks { 0 };
+  Counter playingBlocks { 0 };
+  Counter blocksWithoutPosition { 0 };
+  Counter blockSizeChanges { 0 };
+  std::atomic<int> minBlockSize { 0 };
+  std::atomic<int> maxBlockSize { 0 };
+  std::array<Counter, static_cast<size_t>(Field::numFields)> fieldCounts {};
+  std::array<Counter, static_cast<size_t>(Field::numFields)> playingFieldCounts {};
+  std::array<Counter, numBlockSizeBins> blockSizeCounts {};
+  std::array<Counter, static_cast<size_t>(BeatPhaseSource::numSources)> phaseSourceCounts {};
+  DurationHistogram callbackIntervals;
+  DurationHistogram callbackJitter;
+  DurationHistogram ppqErrors;
+  Counter ppqJumps { 0 };
+
+  // Audio thread only.
+  juce::int64 lastCallbackTicks = 0;
+  double lastBlockSeconds = 0.0;
+  int lastBlockSize = 0;
+};
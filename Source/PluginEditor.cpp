@@ -1,7 +1,15 @@
 #include "PluginEditor.h"
+#include "Diagnostics.h"
+#include "GlyphCache.h"
 #include "PluginProcessor.h"
+#include "Theme.h"
+#include "ThreadedTrafficView.h"
+#include "TiledRenderer.h"
+#include "TraceRecorder.h"
+#include "Visualizers.h"
 
 #include <cmath>
+#include <cstdio>
 
 namespace
 {
@@ -14,63 +22,41 @@ constexpr auto kSubdivisionsParamId = "subdivisions";
 constexpr auto kSoundVolumeParamId = "soundVolume";
 constexpr auto kPreviewSubdivisionsParamId = "previewSubdivisions";
 
-// Color themes
-struct ThemeColors
-{
-  juce::Colour background;
-  juce::Colour accent;
-  juce::Colour accentSecondary;
-  juce::Colour textPrimary;
-  juce::Colour textMuted;
-  juce::Colour panelBg;
-  juce::Colour barMarker;
-};
+constexpr int kNumVisualModes = static_cast<int>(VisualMode::Pattern) + 1;
+
+// The stats overlay text is rebuilt at this rate rather than every frame.
+constexpr double kStatsRefreshIntervalSeconds = 0.25;
+
+// The DSP load readout polls the processor at this rate, also while the editor is idle.
+constexpr double kDspLoadRefreshIntervalSeconds = 0.5;
 
-ThemeColors getThemeColors(ColorTheme theme)
+// Settings panel layout. The sections scroll below a fixed title bar, so the panel works at
+// any editor size.
+constexpr int kSettingsHeaderHeight = 60;
+constexpr int kSettingsMargin = 20;
+constexpr int kSettingsHeadingHeight = 25;
+constexpr int kSettingsButtonHeight = 32;
+constexpr int kSettingsButtonGap = 10;
+constexpr int kSettingsRowGap = 5;
+constexpr int kSettingsSectionGap = 16;
+
+// UI preferences kept on the processor state tree (saved with the session, not automatable).
+constexpr auto kRenderModePropertyId = "renderMode";
+
+// Polyrhythm lane sets offered in the settings, as pulses per bar for each lane. They play
+// against whatever the bar is: 3 in 4/4 is 3-against-4, 5 in 7/8 is 5-against-7.
+constexpr int kNumPolyrhythmPresets = 5;
+const char* const kPolyrhythmPresetLabels[kNumPolyrhythmPresets] = { "Off", "3", "5", "3 + 5", "2+3+5+7" };
+
+PolyrhythmLanes makePolyrhythmPreset(int index)
 {
-  switch (theme)
-  {
-    case ColorTheme::CalmBlue:
-      return {
-        juce::Colour(0xff0b1323), // background
-        juce::Colour(0xff32b7ff), // accent
-        juce::Colour(0xff2da5ff), // accentSecondary
-        juce::Colour(0xffffffff), // textPrimary
-        juce::Colour(0xff9aa8bd), // textMuted
-        juce::Colour(0xff1e2b3e), // panelBg
-        juce::Colour(0xff32b7ff)  // barMarker
-      };
-    case ColorTheme::WarmSunset:
-      return {
-        juce::Colour(0xff1a1210), // background
-        juce::Colour(0xffff9a3c), // accent (orange)
-        juce::Colour(0xffff7b2e), // accentSecondary
-        juce::Colour(0xffffffff), // textPrimary
-        juce::Colour(0xffbda99a), // textMuted
-        juce::Colour(0xff2e201e), // panelBg
-        juce::Colour(0xffff9a3c)  // barMarker
-      };
-    case ColorTheme::ForestMint:
-      return {
-        juce::Colour(0xff0b1a14), // background
-        juce::Colour(0xff3cffaa), // accent (mint)
-        juce::Colour(0xff2ee89a), // accentSecondary
-        juce::Colour(0xffffffff), // textPrimary
-        juce::Colour(0xff9abda8), // textMuted
-        juce::Colour(0xff1e2e28), // panelBg
-        juce::Colour(0xff3cffaa)  // barMarker
-      };
-    case ColorTheme::HighContrast:
-    default:
-      return {
-        juce::Colour(0xff000000), // background (pure black)
-        juce::Colour(0xffffffff), // accent (white)
-        juce::Colour(0xffcccccc), // accentSecondary
-        juce::Colour(0xffffffff), // textPrimary
-        juce::Colour(0xff888888), // textMuted
-        juce::Colour(0xff1a1a1a), // panelBg
-        juce::Colour(0xffffffff)  // barMarker (white)
-      };
+  switch (index)
+  {
+    case 1: return PolyrhythmLanes::fromPulses({ 3 });
+    case 2: return PolyrhythmLanes::fromPulses({ 5 });
+    case 3: return PolyrhythmLanes::fromPulses({ 3, 5 });
+    case 4: return PolyrhythmLanes::fromPulses({ 2, 3, 5, 7 });
+    default: return {};
   }
 }
 
@@ -133,25 +119,20 @@ static juce::Path makePausePath()
   return p;
 }
 
-static float clamp01(float v)
+// Icon outlines never change, so one set is shared by every open editor.
+struct EditorIcons
 {
-  return juce::jlimit(0.0f, 1.0f, v);
-}
-
-static float pulseFromBeatPhase(double beatPhase)
-{
-  const auto phase = clamp01(static_cast<float>(beatPhase));
-  // Fast flash per beat: strong at phase=0, quickly decays (closer to original demo).
-  const auto decay = std::exp(-20.0f * phase);
-  return clamp01(static_cast<float>(decay * decay) * 1.15f);
-}
+  const juce::Path gear = makeGearPath();
+  const juce::Path play = makePlayPath();
+  const juce::Path pause = makePausePath();
+};
 
 // Icon Button
 class IconButton final : public juce::Button
 {
 public:
-  explicit IconButton(juce::Path iconPath)
-      : juce::Button(""), icon(std::move(iconPath))
+  explicit IconButton(const juce::Path EditorIcons::*iconToUse)
+      : juce::Button(""), icon(icons.get().*iconToUse)
   {
     setMouseCursor(juce::MouseCursor::PointingHandCursor);
   }
@@ -172,7 +153,8 @@ public:
   }
 
 private:
-  juce::Path icon;
+  juce::SharedResourcePointer<EditorIcons> icons;
+  const juce::Path& icon;
 };
 
 // Step Button (+/-)
@@ -194,12 +176,18 @@ public:
     g.fillRoundedRectangle(bounds, bounds.getHeight() * 0.35f);
 
     g.setColour(juce::Colours::white.withAlpha(0.9f));
-    g.setFont(juce::Font(bounds.getHeight() * 0.55f, juce::Font::plain));
+    g.setFont(labelFont);
     g.drawText(label, getLocalBounds(), juce::Justification::centred);
   }
 
+  void resized() override
+  {
+    labelFont = juce::Font(static_cast<float>(getHeight()) * 0.55f, juce::Font::plain);
+  }
+
 private:
   juce::String label;
+  juce::Font labelFont { 14.0f, juce::Font::plain };
 };
 
 // Play/Pause Button
@@ -213,7 +201,14 @@ public:
     setMouseCursor(juce::MouseCursor::PointingHandCursor);
   }
 
-  void setAccentColor(juce::Colour c) { accentColor = c; repaint(); }
+  void setAccentColor(juce::Colour c)
+  {
+    if (c == accentColor)
+      return;
+
+    accentColor = c;
+    repaint();
+  }
 
   void paintButton(juce::Graphics& g, bool shouldDrawHover, bool isDown) override
   {
@@ -229,22 +224,50 @@ public:
     g.setColour(juce::Colours::black.withAlpha(0.92f));
 
     auto iconBounds = circle.reduced(circle.getWidth() * 0.30f);
-    const auto icon = getToggleState() ? makePausePath() : makePlayPath();
+    const auto& icon = getToggleState() ? icons->pause : icons->play;
     g.fillPath(icon, icon.getTransformToScaleToFit(iconBounds, true));
   }
 
 private:
   juce::Colour accentColor { 0xff32b7ff };
+  juce::SharedResourcePointer<EditorIcons> icons;
 };
 
-// BPM Readout
+// BPM Readout (click to switch to a bar.beat counter)
 class BpmReadout final : public juce::Component
 {
 public:
+  BpmReadout()
+  {
+    setMouseCursor(juce::MouseCursor::PointingHandCursor);
+    formatBpm();
+    formatCounter();
+  }
+
   void setBpm(double bpmToShow)
   {
+    // Only the rounded value is displayed, so sub-integer tempo drift never repaints.
+    const auto changed = std::round(bpmToShow) != std::round(bpm);
     bpm = bpmToShow;
-    repaint();
+    if (changed)
+    {
+      formatBpm();
+      if (!showCounter)
+        repaint();
+    }
+  }
+
+  // 1-based bar and beat numbers for the counter display. Bars before bar 1 show as 0, -1, ...
+  void setBarBeat(int barNumber, int beatNumber)
+  {
+    if (barNumber == bar && beatNumber == beat)
+      return;
+
+    bar = barNumber;
+    beat = beatNumber;
+    formatCounter();
+    if (showCounter)
+      repaint();
   }
 
   void setColors(juce::Colour primary, juce::Colour muted)
@@ -254,29 +277,192 @@ public:
     repaint();
   }
 
-  void paint(juce::Graphics& g) override
+  void mouseUp(const juce::MouseEvent& e) override
   {
-    auto bounds = getLocalBounds();
+    if (e.mouseWasClicked() && contains(e.getPosition()))
+    {
+      showCounter = !showCounter;
+      repaint();
+    }
+  }
 
-    const auto bpmInt = static_cast<int>(std::round(bpm));
-    const auto numberArea = bounds.removeFromTop(static_cast<int>(bounds.getHeight() * 0.68f));
-    const auto labelArea = bounds;
+  void paint(juce::Graphics& g) override
+  {
+    const ScopedTrace trace("BpmReadout::paint");
+    // Text is drawn from pre-rendered glyph masks; only a (rare) size or scale change
+    // re-rasterises them.
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    updateGlyphs(numberGlyphs, kNumberCharacters, numberFontHeight, true, scale);
+    updateGlyphs(labelGlyphs, kLabelCharacters, labelFontHeight, false, scale);
 
     g.setColour(textColor.withAlpha(0.95f));
-    g.setFont(juce::Font(numberArea.getHeight() * 0.70f, juce::Font::bold));
-    g.drawText(juce::String(bpmInt), numberArea, juce::Justification::centred);
+    numberGlyphs->drawText(g, showCounter ? counterText : bpmText, numberArea.toFloat(), juce::Justification::centred);
 
     g.setColour(mutedColor.withAlpha(0.85f));
-    g.setFont(juce::Font(labelArea.getHeight() * 0.60f, juce::Font::plain));
-    g.drawText("BPM", labelArea, juce::Justification::centred);
+    labelGlyphs->drawText(g, showCounter ? "BAR . BEAT" : "BPM", labelArea.toFloat(), juce::Justification::centred);
+  }
+
+  void resized() override
+  {
+    auto bounds = getLocalBounds();
+    numberArea = bounds.removeFromTop(static_cast<int>(bounds.getHeight() * 0.68f));
+    labelArea = bounds;
+
+    numberFontHeight = static_cast<float>(numberArea.getHeight()) * 0.70f;
+    labelFontHeight = static_cast<float>(labelArea.getHeight()) * 0.60f;
   }
 
 private:
+  // '-' for the bars of a host pre-roll or count-in, before bar 1.
+  static constexpr const char* kNumberCharacters = "-0123456789.";
+  static constexpr const char* kLabelCharacters = "ABEMPRT. ";
+
+  // Glyph masks come from the process-wide set, so every open editor shares them.
+  void updateGlyphs(std::shared_ptr<const GlyphCache>& glyphs, const char* characterSet, float fontHeight, bool bold, float scale)
+  {
+    if (glyphs != nullptr && glyphs->matches(characterSet, fontHeight, bold, scale))
+      return;
+
+    glyphs = glyphCaches->get(GlyphCache::makeKey(characterSet, fontHeight, bold, scale), [=]
+    {
+      auto cache = std::make_shared<GlyphCache>(characterSet);
+      cache->prepare(fontHeight, bold, scale);
+      return cache;
+    });
+  }
+
+  void formatBpm()
+  {
+    std::snprintf(bpmText, sizeof(bpmText), "%d", static_cast<int>(std::round(bpm)));
+  }
+
+  void formatCounter()
+  {
+    std::snprintf(counterText, sizeof(counterText), "%d.%d", bar, beat);
+  }
+
   double bpm = 120.0;
+  int bar = 1;
+  int beat = 1;
+  bool showCounter = false;
+
+  // Fixed buffers so updating the readout never allocates.
+  char bpmText[8] {};
+  char counterText[16] {};
+
+  juce::SharedResourcePointer<GlyphCacheSet> glyphCaches;
+  std::shared_ptr<const GlyphCache> numberGlyphs;
+  std::shared_ptr<const GlyphCache> labelGlyphs;
+  juce::Rectangle<int> numberArea, labelArea;
+  float numberFontHeight = 14.0f;
+  float labelFontHeight = 12.0f;
+
   juce::Colour textColor { 0xffffffff };
   juce::Colour mutedColor { 0xff9aa8bd };
 };
 
+// DSP load readout: this instance's smoothed processBlock load over its worst block (click to
+// reset the worst case)
+class DspLoadReadout final : public juce::Component
+{
+public:
+  DspLoadReadout()
+  {
+    setMouseCursor(juce::MouseCursor::PointingHandCursor);
+    setLoad(0.0, 0.0);
+  }
+
+  std::function<void()> onResetPeak;
+
+  // Proportions of the real-time budget; the text only changes (and repaints) at 0.1% steps.
+  void setLoad(double average, double peak)
+  {
+    const auto newAverage = juce::roundToInt(average * 1000.0);
+    const auto newPeak = juce::roundToInt(peak * 1000.0);
+    if (newAverage == averagePermille && newPeak == peakPermille)
+      return;
+
+    averagePermille = newAverage;
+    peakPermille = newPeak;
+    std::snprintf(averageText, sizeof(averageText), "%.1f%%", averagePermille * 0.1);
+    std::snprintf(peakText, sizeof(peakText), "DSP MAX %.1f%%", peakPermille * 0.1);
+    repaint();
+  }
+
+  void setColors(juce::Colour primary, juce::Colour muted)
+  {
+    textColor = primary;
+    mutedColor = muted;
+    repaint();
+  }
+
+  void mouseUp(const juce::MouseEvent& e) override
+  {
+    if (e.mouseWasClicked() && contains(e.getPosition()) && onResetPeak != nullptr)
+      onResetPeak();
+  }
+
+  void paint(juce::Graphics& g) override
+  {
+    const ScopedTrace trace("DspLoadReadout::paint");
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    updateGlyphs(numberGlyphs, kNumberCharacters, numberFontHeight, scale);
+    updateGlyphs(labelGlyphs, kLabelCharacters, labelFontHeight, scale);
+
+    g.setColour(textColor.withAlpha(0.85f));
+    numberGlyphs->drawText(g, averageText, numberArea.toFloat(), juce::Justification::centred);
+
+    // A block that used its whole budget is an overrun; flag it.
+    g.setColour(peakPermille >= 1000 ? warningColor : mutedColor.withAlpha(0.85f));
+    labelGlyphs->drawText(g, peakText, labelArea.toFloat(), juce::Justification::centred);
+  }
+
+  void resized() override
+  {
+    auto bounds = getLocalBounds();
+    numberArea = bounds.removeFromTop(static_cast<int>(bounds.getHeight() * 0.60f));
+    labelArea = bounds;
+
+    numberFontHeight = static_cast<float>(numberArea.getHeight()) * 0.62f;
+    labelFontHeight = static_cast<float>(labelArea.getHeight()) * 0.62f;
+  }
+
+private:
+  static constexpr const char* kNumberCharacters = "0123456789.%";
+  static constexpr const char* kLabelCharacters = "0123456789.% ADMPSX";
+
+  void updateGlyphs(std::shared_ptr<const GlyphCache>& glyphs, const char* characterSet, float fontHeight, float scale)
+  {
+    if (glyphs != nullptr && glyphs->matches(characterSet, fontHeight, false, scale))
+      return;
+
+    glyphs = glyphCaches->get(GlyphCache::makeKey(characterSet, fontHeight, false, scale), [=]
+    {
+      auto cache = std::make_shared<GlyphCache>(characterSet);
+      cache->prepare(fontHeight, false, scale);
+      return cache;
+    });
+  }
+
+  int averagePermille = -1;
+  int peakPermille = -1;
+
+  // Fixed buffers so updating the readout never allocates.
+  char averageText[16] {};
+  char peakText[24] {};
+
+  juce::SharedResourcePointer<GlyphCacheSet> glyphCaches;
+  std::shared_ptr<const GlyphCache> numberGlyphs;
+  std::shared_ptr<const GlyphCache> labelGlyphs;
+  juce::Rectangle<int> numberArea, labelArea;
+  float numberFontHeight = 12.0f;
+  float labelFontHeight = 9.0f;
+
+  juce::Colour textColor { 0xffffffff };
+  juce::Colour mutedColor { 0xff9aa8bd };
+  const juce::Colour warningColor { 0xffff5a4e };
+};
+
 // Option Button for settings panel
 class OptionButton final : public juce::Button
 {
@@ -289,7 +475,7 @@ public:
   }
 
   void setIndicatorColor(juce::Colour c) { indicatorCol = c; repaint(); }
-  void setTheme(ThemeColors t) { theme = t; repaint(); }
+  void setTheme(const ThemeColors& t) { theme = t; repaint(); }
 
   void paintButton(juce::Graphics& g, bool shouldDrawHover, bool isDown) override
   {
@@ -324,13 +510,14 @@ public:
 
     // Text
     g.setColour((selected ? theme.textPrimary : theme.textMuted).withAlpha(selected ? 0.98f : 0.92f));
-    g.setFont(juce::Font(14.0f, juce::Font::plain));
+    g.setFont(labelFont);
     auto textBounds = bounds.withLeft(textStartX).withRight(bounds.getRight() - 8.0f);
     g.drawText(label, textBounds, juce::Justification::centredLeft);
   }
 
 private:
   juce::String label;
+  juce::Font labelFont { 14.0f, juce::Font::plain };
   bool showIndicator;
   juce::Colour indicatorCol;
   ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
@@ -338,509 +525,6 @@ private:
 
 } // namespace
 
-//==============================================================================
-// Pulse Visualizer
-//==============================================================================
-class VizBeatsAudioProcessorEditor::PulseVisualizer final : public juce::Component
-{
-public:
-  void setPulse(float newPulse)
-  {
-    const float target = clamp01(newPulse);
-    // Snappier response (fast flash per beat).
-    constexpr float smoothing = 0.28f;
-    smoothedPulse = smoothedPulse * (1.0f - smoothing) + target * smoothing;
-  }
-
-  void setRunning(bool shouldRun) { running = shouldRun; }
-  void setColors(ThemeColors colors) { theme = colors; repaint(); }
-
-  void paint(juce::Graphics& g) override
-  {
-    auto bounds = getLocalBounds().toFloat();
-
-    // Fill background with theme color
-    g.setColour(theme.background);
-    g.fillRect(bounds);
-
-    const auto size = juce::jmin(bounds.getWidth(), bounds.getHeight());
-    const auto centre = bounds.getCentre();
-
-    const auto maxRadius = size * 0.60f;
-    const auto minRadius = size * 0.10f;
-
-    const auto decay = (running ? smoothedPulse : 0.0f);
-    const auto radius = minRadius + (maxRadius - minRadius) * decay;
-
-    const auto alpha = 0.14f + 0.82f * decay;
-    const auto stroke = juce::jlimit(1.4f, 9.5f, maxRadius * (0.010f + 0.024f * decay));
-
-    const auto ringBounds = juce::Rectangle<float>(radius * 2.0f, radius * 2.0f).withCentre(centre);
-
-    g.setColour(theme.accent.withAlpha(alpha * 0.42f));
-    g.fillEllipse(ringBounds);
-
-    g.setColour(theme.accent.withAlpha(alpha * 0.78f));
-    g.drawEllipse(ringBounds, stroke * 1.05f);
-
-    // soft glow behind the core
-    const auto glowRadius = size * 0.11f;
-    auto glowBounds = juce::Rectangle<float>(glowRadius * 2.0f, glowRadius * 2.0f).withCentre(centre);
-    juce::ColourGradient glow(theme.accent.withAlpha(0.28f * decay), centre, theme.accent.withAlpha(0.0f), glowBounds.getBottomRight(), true);
-    g.setGradientFill(glow);
-    g.fillEllipse(glowBounds);
-
-    const auto coreRadius = size * 0.085f;
-    const auto coreBounds = juce::Rectangle<float>(coreRadius * 2.0f, coreRadius * 2.0f).withCentre(centre);
-
-    g.setColour(theme.accentSecondary.withAlpha(0.97f));
-    g.drawEllipse(coreBounds, stroke * 0.65f);
-
-    const auto dotRadius = juce::jmax(2.6f, size * 0.011f);
-    g.fillEllipse(juce::Rectangle<float>(dotRadius * 2.0f, dotRadius * 2.0f).withCentre(centre));
-  }
-
-private:
-  float smoothedPulse = 1.0f;
-  bool running = false;
-  ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
-};
-
-//==============================================================================
-// Traffic Visualizer - horizontal beat timeline with marker interactions
-//==============================================================================
-class VizBeatsAudioProcessorEditor::TrafficVisualizer final : public juce::Component
-{
-public:
-  void setBeatPhase(double phase) { beatPhase = phase; }
-  void setRunning(bool shouldRun) { running = shouldRun; }
-  void setBeatsPerBar(int beats) { beatsPerBar = juce::jmax(1, beats); }
-  void setSubdivisions(int subs) { subdivisions = juce::jmax(1, subs); }
-  void setCurrentBeat(int beat) { currentBeat = beat; }
-  void setColors(ThemeColors colors) { theme = colors; repaint(); }
-
-	  void paint(juce::Graphics& g) override
-	  {
-	    const auto nowMs = juce::Time::getMillisecondCounter();
-	    float dtSeconds = 0.0f;
-	    if (lastPaintTimeMs != 0)
-	      dtSeconds = juce::jlimit(0.0f, 0.10f, static_cast<float>(nowMs - lastPaintTimeMs) * 0.001f);
-	    lastPaintTimeMs = nowMs;
-
-	    auto bounds = getLocalBounds().toFloat();
-
-	    // Background: use the theme base colour (no left-side brightening).
-	    g.setColour(theme.background);
-	    g.fillRect(bounds);
-
-	    const auto centreY = bounds.getCentreY();
-	    const auto padding = 88.0f;
-	    const auto lineStartX = padding;
-	    const auto lineEndX = bounds.getWidth() - padding;
-	    const auto lineWidth = lineEndX - lineStartX;
-	    const float barWidth = 5.0f;
-	    const float barHeight = 120.0f;
-	    const float barY = centreY - barHeight * 0.5f;
-
-    // Total visual segments (beats * subdivisions for visual markers)
-    const int totalSegments = juce::jmax(1, beatsPerBar * subdivisions);
-    const float markerSpacing = lineWidth / static_cast<float>(totalSegments);
-
-    // Main beat segments (for ripples only)
-    const int mainBeatSegments = juce::jmax(1, beatsPerBar);
-
-    // Orb position: constant speed across the whole bar.
-    const float barProgress01 = running
-                                  ? clamp01(static_cast<float>((static_cast<double>(currentBeat) + beatPhase) / static_cast<double>(beatsPerBar)))
-                                  : 0.0f;
-
-	    // Track orb position relative to main beats only (for ripples)
-	    const float orbMainBeatSpace = barProgress01 * static_cast<float>(mainBeatSegments);
-	    const float orbX = lineStartX + barProgress01 * lineWidth;
-	    const float orbY = centreY;
-
-	    // Orb brightens near main beat markers only ("activation" feel).
-	    const float distToNearest = std::abs(orbMainBeatSpace - std::round(orbMainBeatSpace));
-	    const float hit = running ? std::exp(-distToNearest * distToNearest * 110.0f) : 0.0f;
-
-	    // Decaying left flash pulse (triggered on bar wrap).
-	    if (dtSeconds > 0.0f && leftFlash > 0.0f)
-	    {
-	      leftFlash *= std::exp(-dtSeconds * 6.5f);
-	      if (leftFlash < 0.001f)
-	        leftFlash = 0.0f;
-	    }
-
-	    bool barWrapped = false;
-	    if (running)
-	    {
-	      if (lastBarProgress01 >= 0.0f)
-	        barWrapped = (barProgress01 + 0.10f < lastBarProgress01);
-
-	      lastBarProgress01 = barProgress01;
-
-	      if (barWrapped)
-	        leftFlash = 1.0f;
-	    }
-	    else
-	    {
-	      lastBarProgress01 = -1.0f;
-	      leftFlash = 0.0f;
-	    }
-
-	    const float leftPulse = leftFlash;
-
-	    // Keep a small "hit" pulse at the right bar for the orb only (right bar itself should not light up).
-	    float rightPulse = 0.0f;
-	    if (running)
-	    {
-	      const auto pulseFromDistance = [](float distPx, float sigmaPx)
-	      {
-	        if (sigmaPx <= 0.0f)
-	          return 0.0f;
-
-	        const float x = distPx / sigmaPx;
-	        float v = std::exp(-0.5f * x * x);
-	        v *= v;
-	        return clamp01(v);
-	      };
-
-	      const auto gate = [](float v, float threshold)
-	      {
-	        if (v <= threshold)
-	          return 0.0f;
-	        return clamp01((v - threshold) / (1.0f - threshold));
-	      };
-
-	      const float rightHit = pulseFromDistance(std::abs(orbX - lineEndX), 14.0f);
-	      rightPulse = gate(rightHit, 0.10f);
-	    }
-
-	    // Left-side screen flash (momentary) when the ball reaches the left bar.
-	    if (leftPulse > 0.0f)
-	    {
-	      const float intensity = clamp01(leftPulse);
-	      const float leftBarX = lineStartX - barWidth - 10.0f;
-	      const float entryX = leftBarX + barWidth * 0.5f;
-	      const float entryY = centreY;
-
-	      const auto bgArgb = theme.background.getARGB();
-	      const auto accentArgb = theme.accent.getARGB();
-	      const auto accent2Argb = theme.accentSecondary.getARGB();
-	      const auto flashKey =
-	          (static_cast<juce::uint64>(bgArgb) << 32)
-	          ^ static_cast<juce::uint64>(accentArgb)
-	          ^ (static_cast<juce::uint64>(accent2Argb) << 1);
-
-	      const int w = juce::jmax(1, static_cast<int>(std::round(bounds.getWidth())));
-	      const int h = juce::jmax(1, static_cast<int>(std::round(bounds.getHeight())));
-
-	      if (leftFlashOverlay.isNull() || leftFlashOverlay.getWidth() != w || leftFlashOverlay.getHeight() != h || leftFlashOverlayKey != flashKey)
-	      {
-	        leftFlashOverlayKey = flashKey;
-	        leftFlashOverlay = juce::Image(juce::Image::ARGB, w, h, true);
-
-	        juce::Image::BitmapData bd(leftFlashOverlay, juce::Image::BitmapData::writeOnly);
-
-	        const float wf = static_cast<float>(w);
-	        const float hf = static_cast<float>(h);
-
-	        // Smooth ambient wash - gradual fade from left edge to center
-	        const float fadeWidth = wf * 0.45f; // How far the glow extends horizontally
-
-	        const float ditherScale = 1.5f / 255.0f;
-	        const auto seed = static_cast<juce::uint32>((flashKey >> 32) ^ (flashKey & 0xffffffffu));
-	        juce::Random rng(static_cast<int>(seed));
-
-	        for (int py = 0; py < h; ++py)
-	        {
-	          for (int px = 0; px < w; ++px)
-	          {
-	            const float x = static_cast<float>(px);
-
-	            // Simple horizontal fade from left edge
-	            float horizontalFade = 1.0f - (x / fadeWidth);
-	            horizontalFade = juce::jmax(0.0f, horizontalFade);
-	            // Smooth cubic falloff for natural look
-	            horizontalFade = horizontalFade * horizontalFade * (3.0f - 2.0f * horizontalFade);
-
-	            float a = horizontalFade * 0.50f; // Max alpha at left edge - more kick!
-
-	            if (a < 0.002f)
-	            {
-	              bd.setPixelColour(px, py, juce::Colours::transparentBlack);
-	              continue;
-	            }
-
-	            // Add subtle dithering to prevent banding
-	            a += (rng.nextFloat() - 0.5f) * ditherScale;
-	            a = clamp01(a);
-
-	            bd.setPixelColour(px, py, theme.accent.withAlpha(a));
-	          }
-	        }
-	      }
-
-	      juce::Graphics::ScopedSaveState state(g);
-	      g.setOpacity(intensity * 0.85f);
-	      g.drawImageAt(leftFlashOverlay, 0, 0);
-	    }
-
-	    // Baseline line (draw after possible wash so it stays crisp).
-	    g.setColour(theme.textMuted.withAlpha(0.22f));
-	    g.drawLine(lineStartX, centreY, lineEndX, centreY, 1.0f);
-
-	    // Side bars.
-	    auto drawSideBar = [&](float x, bool isLeft, float pulse)
-	    {
-	      // Keep both bars the same colour; only the left bar receives a hit overlay.
-	      constexpr float baseAlpha = 0.35f;
-	      g.setColour(theme.barMarker.withAlpha(baseAlpha));
-	      g.fillRect(x, barY, barWidth, barHeight);
-
-      pulse = clamp01(pulse);
-      if (pulse <= 0.0f)
-        return;
-
-      // Subtle bar highlight when hit
-      const float overlayAlpha = (isLeft ? 0.25f : 0.95f) * pulse;
-      g.setColour(theme.barMarker.withAlpha(overlayAlpha));
-      g.fillRect(x, barY, barWidth, barHeight);
-    };
-
-	    drawSideBar(lineStartX - barWidth - 10.0f, true, leftPulse);
-	    drawSideBar(lineEndX + 10.0f, false, 0.0f);
-
-    // Ripples: emit when orb passes a MAIN BEAT marker only (not subdivisions).
-    const float mainBeatMarkerSpacing = lineWidth / static_cast<float>(mainBeatSegments);
-    if (running)
-    {
-      if (lastOrbMarkerSpace < 0.0f)
-      {
-        lastOrbMarkerSpace = orbMainBeatSpace;
-      }
-      else
-      {
-        const bool wrapped = orbMainBeatSpace + 0.25f < lastOrbMarkerSpace;
-        if (wrapped)
-        {
-          ripples.clear();
-        }
-        else
-        {
-          const int lastIdx = static_cast<int>(std::floor(lastOrbMarkerSpace));
-          const int nowIdx = static_cast<int>(std::floor(orbMainBeatSpace));
-          if (nowIdx > lastIdx)
-          {
-            for (int i = lastIdx + 1; i <= nowIdx; ++i)
-            {
-              // Ripples only at main beat positions
-              const float x = lineStartX + static_cast<float>(juce::jlimit(0, mainBeatSegments, i)) * mainBeatMarkerSpacing;
-              ripples.push_back({ x, centreY, 0.0f });
-            }
-          }
-        }
-        lastOrbMarkerSpace = orbMainBeatSpace;
-      }
-    }
-    else
-    {
-      lastOrbMarkerSpace = -1.0f;
-      ripples.clear();
-    }
-
-    // Draw all visual markers (main beats + subdivisions)
-    for (int i = 0; i <= totalSegments; ++i)
-    {
-      const float x = lineStartX + static_cast<float>(i) * markerSpacing;
-
-      // No end-circles near the side bars (matches reference).
-      if (i == 0 || i == totalSegments)
-        continue;
-
-      // Main beats are larger, subdivisions are smaller
-      const bool isMainBeat = (i % subdivisions) == 0;
-      const float size = isMainBeat ? 7.0f : 4.5f;
-      const float stroke = isMainBeat ? 1.3f : 0.9f;
-      const float alpha = isMainBeat ? 0.35f : 0.20f;
-
-      // ring markers stay static (no proximity glow); ripples handle "hit" feedback.
-      g.setColour(theme.textMuted.withAlpha(alpha));
-      g.drawEllipse(x - size * 0.5f, centreY - size * 0.5f, size, size, stroke);
-    }
-
-    // Draw ripples after markers.
-    if (!ripples.empty())
-    {
-      constexpr float lifeSeconds = 0.28f;
-      const float speed = 120.0f; // px/sec
-
-      for (auto& r : ripples)
-        r.ageSeconds += dtSeconds;
-
-      ripples.erase(
-          std::remove_if(ripples.begin(), ripples.end(), [lifeSeconds](const Ripple& r) { return r.ageSeconds >= lifeSeconds; }),
-          ripples.end());
-
-      for (const auto& r : ripples)
-      {
-        const float t = clamp01(r.ageSeconds / lifeSeconds);
-        const float radius = 4.0f + t * speed * lifeSeconds;
-        const float alpha = (1.0f - t);
-        const float stroke = 4.4f - 1.4f * t;
-
-        // Outer ring (more prominent)
-        g.setColour(theme.accent.withAlpha(0.52f * alpha));
-        g.drawEllipse(r.x - radius, r.y - radius, radius * 2.0f, radius * 2.0f, stroke);
-
-        // Inner highlight
-        g.setColour(juce::Colours::white.withAlpha(0.18f * alpha));
-        g.drawEllipse(r.x - radius * 0.82f, r.y - radius * 0.82f, radius * 1.64f, radius * 1.64f, stroke * 0.62f);
-
-        // Soft halo
-        g.setColour(theme.accent.withAlpha(0.20f * alpha));
-        g.drawEllipse(r.x - radius * 1.12f, r.y - radius * 1.12f, radius * 2.24f, radius * 2.24f, stroke * 0.55f);
-      }
-    }
-
-    // Orb
-    if (running)
-    {
-      // Orb should not glow all the time: keep glow mostly tied to "hits".
-      const float glowAmt = 0.05f + 0.70f * hit + 0.20f * (leftPulse + rightPulse);
-
-      // Tail: starts at zero length and grows.
-      const float progress01 = barProgress01;
-      const float tailLength = 115.0f * progress01;
-      const float tailHeight = 5.6f + 3.2f * progress01;
-
-      const float tailStartX = juce::jmax(lineStartX, orbX - tailLength);
-      const float tailEndX = orbX - 8.0f;
-      if (tailEndX > tailStartX)
-      {
-        // Tapered streak (sharper, like the reference).
-        const float halfEnd = tailHeight * 0.52f;
-        const float halfStart = tailHeight * 0.22f;
-
-        const float tailAmt = juce::jlimit(0.0f, 1.0f, 0.22f + 0.78f * progress01 + 0.22f * hit);
-
-        const auto tailCol = theme.accent.darker(0.45f);
-
-        // Soft outer plume
-        {
-          const float oEnd = halfEnd * 1.45f;
-          const float oStart = halfStart * 1.35f;
-
-          juce::Path plume;
-          plume.startNewSubPath(tailStartX, orbY - oStart);
-          plume.lineTo(tailEndX, orbY - oEnd);
-          plume.lineTo(tailEndX, orbY + oEnd);
-          plume.lineTo(tailStartX, orbY + oStart);
-          plume.closeSubPath();
-
-          juce::ColourGradient plumeGrad(
-              tailCol.withAlpha(0.18f * tailAmt),
-              tailEndX,
-              orbY,
-              tailCol.withAlpha(0.0f),
-              tailStartX,
-              orbY,
-              false);
-          g.setGradientFill(plumeGrad);
-          g.fillPath(plume);
-        }
-
-        juce::Path streak;
-        streak.startNewSubPath(tailStartX, orbY - halfStart);
-        streak.lineTo(tailEndX, orbY - halfEnd);
-        streak.lineTo(tailEndX, orbY + halfEnd);
-        streak.lineTo(tailStartX, orbY + halfStart);
-        streak.closeSubPath();
-
-        juce::ColourGradient streakGlow(
-            tailCol.withAlpha(0.30f * tailAmt),
-            tailEndX,
-            orbY,
-            tailCol.withAlpha(0.0f),
-            tailStartX,
-            orbY,
-            false);
-        g.setGradientFill(streakGlow);
-        g.fillPath(streak);
-
-        juce::Path core;
-        const float coreHalfEnd = halfEnd * 0.32f;
-        const float coreHalfStart = halfStart * 0.28f;
-        core.startNewSubPath(tailStartX, orbY - coreHalfStart);
-        core.lineTo(tailEndX, orbY - coreHalfEnd);
-        core.lineTo(tailEndX, orbY + coreHalfEnd);
-        core.lineTo(tailStartX, orbY + coreHalfStart);
-        core.closeSubPath();
-
-        juce::ColourGradient streakCore(
-            theme.accentSecondary.withAlpha(0.18f * tailAmt),
-            tailEndX,
-            orbY,
-            theme.accentSecondary.withAlpha(0.0f),
-            tailStartX,
-            orbY,
-            false);
-        g.setGradientFill(streakCore);
-        g.fillPath(core);
-      }
-
-      // Minimal orb halo only when needed.
-      if (glowAmt > 0.08f)
-      {
-        const float halo = 34.0f + 26.0f * glowAmt;
-        juce::ColourGradient haloG(
-            theme.accent.withAlpha(0.22f * glowAmt),
-            orbX,
-            orbY,
-            theme.accent.withAlpha(0.0f),
-            orbX + halo * 0.5f,
-            orbY,
-            true);
-        g.setGradientFill(haloG);
-        g.fillEllipse(orbX - halo * 0.5f, orbY - halo * 0.5f, halo, halo);
-      }
-
-      const float orbSize = 16.0f;
-      g.setColour(juce::Colours::white.withAlpha(0.97f));
-      g.fillEllipse(orbX - orbSize * 0.5f, orbY - orbSize * 0.5f, orbSize, orbSize);
-
-      // Tiny accent edge to tie into theme.
-      g.setColour(theme.accent.withAlpha(0.20f + 0.25f * glowAmt));
-      g.drawEllipse(orbX - orbSize * 0.5f, orbY - orbSize * 0.5f, orbSize, orbSize, 1.2f);
-    }
-  }
-
-	private:
-	  struct Ripple
-	  {
-	    float x = 0.0f;
-	    float y = 0.0f;
-	    float ageSeconds = 0.0f;
-	  };
-
-	  double beatPhase = 0.0;
-	  bool running = false;
-	  int beatsPerBar = 4;
-	  int subdivisions = 1;
-	  int currentBeat = 0;
-	  ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
-
-	  juce::uint32 lastPaintTimeMs = 0;
-	  float leftFlash = 0.0f;
-	  float lastBarProgress01 = -1.0f;
-	  float lastOrbMarkerSpace = -1.0f;
-
-	  juce::Image leftFlashOverlay;
-	  juce::uint64 leftFlashOverlayKey = 0;
-
-	  std::vector<Ripple> ripples;
-	};
-
 //==============================================================================
 // Settings Panel
 //==============================================================================
@@ -850,12 +534,15 @@ public:
   explicit SettingsPanel(VizBeatsAudioProcessor& p)
       : processor(p)
   {
-    // Visual Mode: only Traffic is enabled (other modes were causing host crashes).
-    auto trafficBtn = std::make_unique<OptionButton>("Traffic");
-    trafficBtn->setRadioGroupId(1);
-    trafficBtn->onClick = [this] { setTrafficMode(); };
-    addAndMakeVisible(*trafficBtn);
-    visualModeButtons.push_back(std::move(trafficBtn));
+    // Visual mode buttons, in parameter order
+    for (int i = 0; i < kNumVisualModes; ++i)
+    {
+      auto btn = std::make_unique<OptionButton>(getVisualModeName(static_cast<VisualMode>(i)));
+      btn->setRadioGroupId(1);
+      btn->onClick = [this, i] { setVisualMode(i); };
+      content.addAndMakeVisible(*btn);
+      visualModeButtons.push_back(std::move(btn));
+    }
 
     // Color theme buttons
     const juce::Colour themeIndicators[] = {
@@ -871,7 +558,7 @@ public:
       auto btn = std::make_unique<OptionButton>(themeLabels[i], true, themeIndicators[i]);
       btn->setRadioGroupId(2);
       btn->onClick = [this, i] { setColorTheme(i); };
-      addAndMakeVisible(*btn);
+      content.addAndMakeVisible(*btn);
       colorThemeButtons.push_back(std::move(btn));
     }
 
@@ -880,7 +567,7 @@ public:
     beatsPerBarSlider.setRange(1, 16, 1);
     beatsPerBarSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 40, 24);
     beatsPerBarSlider.onValueChange = [this] { setBeatsPerBar(static_cast<int>(beatsPerBarSlider.getValue())); };
-    addAndMakeVisible(beatsPerBarSlider);
+    content.addAndMakeVisible(beatsPerBarSlider);
 
     // Subdivision buttons
     for (int i = 0; i < 4; ++i)
@@ -889,7 +576,7 @@ public:
       auto btn = std::make_unique<OptionButton>(label);
       btn->setRadioGroupId(3);
       btn->onClick = [this, i] { setSubdivisions(i + 1); };
-      addAndMakeVisible(*btn);
+      content.addAndMakeVisible(*btn);
       subdivisionButtons.push_back(std::move(btn));
     }
 
@@ -898,18 +585,52 @@ public:
     volumeSlider.setRange(0.0, 1.0, 0.01);
     volumeSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     volumeSlider.onValueChange = [this] { setVolume(static_cast<float>(volumeSlider.getValue())); };
-    addAndMakeVisible(volumeSlider);
+    content.addAndMakeVisible(volumeSlider);
+
+    // Rendering: where the visualizer is rasterised (UI only, not a plugin parameter)
+    const char* renderModeLabels[] = { "Message thread", "Render thread", "Tiled" };
+    for (int i = 0; i < 3; ++i)
+    {
+      auto btn = std::make_unique<OptionButton>(renderModeLabels[i]);
+      btn->setRadioGroupId(4);
+      btn->onClick = [this, i] { if (onRenderModeChanged) onRenderModeChanged(static_cast<RenderMode>(i)); };
+      content.addAndMakeVisible(*btn);
+      renderModeButtons.push_back(std::move(btn));
+    }
+
+    // Polyrhythm lanes (saved with the plugin state, not a parameter)
+    for (int i = 0; i < kNumPolyrhythmPresets; ++i)
+    {
+      auto btn = std::make_unique<OptionButton>(kPolyrhythmPresetLabels[i]);
+      btn->setRadioGroupId(5);
+      btn->onClick = [this, i] { processor.setPolyrhythmLanes(makePolyrhythmPreset(i)); };
+      content.addAndMakeVisible(*btn);
+      polyrhythmButtons.push_back(std::move(btn));
+    }
+
+    // Diagnostics: frame stats overlay (UI only, not a plugin parameter)
+    frameStatsButton.onClick = [this] { if (onFrameStatsToggled) onFrameStatsToggled(frameStatsButton.getToggleState()); };
+    content.addAndMakeVisible(frameStatsButton);
 
     // Close button
     closeButton.setButtonText("Close");
     closeButton.onClick = [this] { if (onClose) onClose(); };
     addAndMakeVisible(closeButton);
 
+    // Sections scroll under the title bar
+    viewport.setViewedComponent(&content, false);
+    viewport.setScrollBarsShown(true, false);
+    addAndMakeVisible(viewport);
+
     refreshFromProcessor();
   }
 
-  void setColors(ThemeColors colors)
+  void setColors(const ThemeColors& colors, juce::uint32 generation)
   {
+    if (generation == themeGeneration)
+      return;
+
+    themeGeneration = generation;
     theme = colors;
 
     // keep theme indicators in sync with actual theme palette
@@ -933,18 +654,30 @@ public:
     for (size_t i = 0; i < subdivisionButtons.size(); ++i)
       subdivisionButtons[i]->setTheme(theme);
 
+    for (size_t i = 0; i < renderModeButtons.size(); ++i)
+      renderModeButtons[i]->setTheme(theme);
+
+    for (size_t i = 0; i < polyrhythmButtons.size(); ++i)
+      polyrhythmButtons[i]->setTheme(theme);
+
+    frameStatsButton.setTheme(theme);
+
+    content.setHeadingColour(theme.textMuted.withAlpha(0.95f));
+    viewport.getVerticalScrollBar().setColour(juce::ScrollBar::thumbColourId, theme.textMuted.withAlpha(0.6f));
+
     repaint();
   }
 
   void refreshFromProcessor()
   {
+    const auto visualMode = static_cast<int>(processor.getVisualMode());
     const auto colorTheme = static_cast<int>(processor.getColorTheme());
     const auto beatsPerBar = processor.getBeatsPerBar();
     const auto subdivisions = processor.getSubdivisions();
     const auto volume = processor.getSoundVolume();
 
-    if (!visualModeButtons.empty())
-      visualModeButtons.front()->setToggleState(true, juce::dontSendNotification);
+    for (size_t i = 0; i < visualModeButtons.size(); ++i)
+      visualModeButtons[i]->setToggleState(static_cast<int>(i) == visualMode, juce::dontSendNotification);
 
     for (size_t i = 0; i < colorThemeButtons.size(); ++i)
       colorThemeButtons[i]->setToggleState(static_cast<int>(i) == colorTheme, juce::dontSendNotification);
@@ -955,12 +688,28 @@ public:
       subdivisionButtons[i]->setToggleState(static_cast<int>(i) + 1 == subdivisions, juce::dontSendNotification);
 
     volumeSlider.setValue(volume, juce::dontSendNotification);
+
+    // Lanes restored from a session may match none of the presets.
+    const auto& lanes = processor.getPolyrhythmLanes();
+    for (size_t i = 0; i < polyrhythmButtons.size(); ++i)
+      polyrhythmButtons[i]->setToggleState(makePolyrhythmPreset(static_cast<int>(i)) == lanes, juce::dontSendNotification);
   }
 
   std::function<void()> onClose;
+  std::function<void(bool)> onFrameStatsToggled;
+  std::function<void(RenderMode)> onRenderModeChanged;
+
+  void setFrameStatsShown(bool shown) { frameStatsButton.setToggleState(shown, juce::dontSendNotification); }
+
+  void setRenderModeShown(RenderMode mode)
+  {
+    for (size_t i = 0; i < renderModeButtons.size(); ++i)
+      renderModeButtons[i]->setToggleState(static_cast<int>(i) == static_cast<int>(mode), juce::dontSendNotification);
+  }
 
   void paint(juce::Graphics& g) override
   {
+    const ScopedTrace trace("SettingsPanel::paint");
     auto bounds = getLocalBounds().toFloat();
 
     // Dark panel background with rounded corners
@@ -974,15 +723,6 @@ public:
     g.setColour(theme.textPrimary);
     g.setFont(juce::Font(20.0f, juce::Font::bold));
     g.drawText("Settings", 20, 20, 200, 30, juce::Justification::centredLeft);
-
-    // Section labels
-    g.setFont(juce::Font(14.0f, juce::Font::plain));
-    g.setColour(theme.textMuted.withAlpha(0.95f));
-    g.drawText("Visual Mode", 20, 60, 200, 20, juce::Justification::centredLeft);
-    g.drawText("Color Theme", 20, 160, 200, 20, juce::Justification::centredLeft);
-    g.drawText("Beats Per Bar", 20, 260, 200, 20, juce::Justification::centredLeft);
-    g.drawText("Subdivisions", 20, 320, 250, 20, juce::Justification::centredLeft);
-    g.drawText("Sound Volume", 20, 400, 200, 20, juce::Justification::centredLeft);
   }
 
   void resized() override
@@ -992,41 +732,111 @@ public:
     // Close button
     closeButton.setBounds(bounds.getWidth() - 40, 20, 60, 30);
 
-    // Visual Mode button (Traffic only)
-    auto visualModeArea = juce::Rectangle<int>(20, 85, bounds.getWidth() - 20, 60);
-    const int btnHeight = 32;
+    // The content keeps room for the scroll bar, so its layout doesn't change when the
+    // scroll bar comes and goes.
+    viewport.setBounds(0, kSettingsHeaderHeight, getWidth() - 6, getHeight() - kSettingsHeaderHeight - 12);
+    const auto contentWidth = viewport.getWidth() - viewport.getScrollBarThickness();
+    content.setSize(contentWidth, layoutContent(contentWidth));
+  }
 
-    if (!visualModeButtons.empty())
-      visualModeButtons.front()->setBounds(visualModeArea.getX(), visualModeArea.getY(), juce::jmin(220, visualModeArea.getWidth()), btnHeight);
+private:
+  // Scrolling body of the panel: every section's controls, with the headings drawn here.
+  class Content final : public juce::Component
+  {
+  public:
+    void setHeadingColour(juce::Colour colour)
+    {
+      headingColour = colour;
+      repaint();
+    }
 
-    // Color Theme buttons (2 rows of 2)
-    auto colorThemeArea = juce::Rectangle<int>(20, 185, bounds.getWidth() - 20, 60);
-    const int themeBtnWidth = (colorThemeArea.getWidth() - 10) / 2;
+    void clearHeadings() { headings.clear(); }
+    void addHeading(const char* text, int y) { headings.push_back({ text, y }); }
 
-    for (int i = 0; i < 2; ++i)
-      colorThemeButtons[static_cast<size_t>(i)]->setBounds(colorThemeArea.getX() + i * (themeBtnWidth + 10), colorThemeArea.getY(), themeBtnWidth, btnHeight);
+    void paint(juce::Graphics& g) override
+    {
+      g.setFont(juce::Font(14.0f, juce::Font::plain));
+      g.setColour(headingColour);
 
-    for (int i = 2; i < 4; ++i)
-      colorThemeButtons[static_cast<size_t>(i)]->setBounds(colorThemeArea.getX() + (i - 2) * (themeBtnWidth + 10), colorThemeArea.getY() + btnHeight + 5, themeBtnWidth, btnHeight);
+      for (const auto& heading : headings)
+        g.drawText(heading.text, kSettingsMargin, heading.y, getWidth() - 2 * kSettingsMargin, 20, juce::Justification::centredLeft);
+    }
 
-    // Beats per bar slider
-    beatsPerBarSlider.setBounds(20, 285, bounds.getWidth() - 20, 24);
+  private:
+    struct Heading
+    {
+      const char* text;
+      int y;
+    };
 
-    // Subdivision buttons
-    auto subArea = juce::Rectangle<int>(20, 345, bounds.getWidth() - 20, 40);
-    const int subBtnWidth = (subArea.getWidth() - 30) / 4;
-    for (int i = 0; i < 4; ++i)
-      subdivisionButtons[static_cast<size_t>(i)]->setBounds(subArea.getX() + i * (subBtnWidth + 10), subArea.getY(), subBtnWidth, btnHeight);
+    std::vector<Heading> headings;
+    juce::Colour headingColour = juce::Colours::grey;
+  };
 
-    // Volume slider
-    volumeSlider.setBounds(50, 425, bounds.getWidth() - 70, 24);
+  // Lays the sections out top to bottom at the given width; returns the height they take.
+  int layoutContent(int width)
+  {
+    const auto rowWidth = width - 2 * kSettingsMargin;
+    int y = 0;
+    content.clearHeadings();
+
+    const auto addHeading = [this, &y](const char* text)
+    {
+      content.addHeading(text, y);
+      y += kSettingsHeadingHeight;
+    };
+
+    // Option buttons in a grid of `columns` across the row.
+    const auto layoutButtons = [&y, rowWidth](std::vector<std::unique_ptr<OptionButton>>& buttons, int columns)
+    {
+      const auto buttonWidth = (rowWidth - (columns - 1) * kSettingsButtonGap) / columns;
+      for (size_t i = 0; i < buttons.size(); ++i)
+      {
+        const auto column = static_cast<int>(i) % columns;
+        const auto row = static_cast<int>(i) / columns;
+        buttons[i]->setBounds(kSettingsMargin + column * (buttonWidth + kSettingsButtonGap),
+                              y + row * (kSettingsButtonHeight + kSettingsRowGap), buttonWidth, kSettingsButtonHeight);
+      }
+
+      const auto rows = (static_cast<int>(buttons.size()) + columns - 1) / columns;
+      y += rows * kSettingsButtonHeight + (rows - 1) * kSettingsRowGap + kSettingsSectionGap;
+    };
+
+    addHeading("Visual Mode");
+    layoutButtons(visualModeButtons, 3);
+
+    addHeading("Color Theme");
+    layoutButtons(colorThemeButtons, 2);
+
+    addHeading("Beats Per Bar");
+    beatsPerBarSlider.setBounds(kSettingsMargin, y, rowWidth, 24);
+    y += 24 + kSettingsSectionGap;
+
+    addHeading("Subdivisions");
+    layoutButtons(subdivisionButtons, 4);
+
+    addHeading("Sound Volume");
+    volumeSlider.setBounds(kSettingsMargin + 30, y, rowWidth - 30, 24);
+    y += 24 + kSettingsSectionGap;
+
+    addHeading("Diagnostics");
+    frameStatsButton.setBounds(kSettingsMargin, y, juce::jmin(220, rowWidth), kSettingsButtonHeight);
+    y += kSettingsButtonHeight + kSettingsSectionGap;
+
+    addHeading("Rendering");
+    layoutButtons(renderModeButtons, 3);
+
+    addHeading("Polyrhythm (pulses per bar)");
+    layoutButtons(polyrhythmButtons, kNumPolyrhythmPresets);
+
+    content.repaint();
+    return y;
   }
 
-private:
-  void setTrafficMode()
+  void setVisualMode(int mode)
   {
     if (auto* param = processor.apvts.getParameter(kVisualModeParamId))
-      param->setValueNotifyingHost(param->convertTo0to1(1.0f));
+      param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(mode)));
   }
 
   void setColorTheme(int theme)
@@ -1055,15 +865,202 @@ private:
 
   VizBeatsAudioProcessor& processor;
 
+  Content content;
+  juce::Viewport viewport;
+
   std::vector<std::unique_ptr<OptionButton>> visualModeButtons;
   std::vector<std::unique_ptr<OptionButton>> colorThemeButtons;
   std::vector<std::unique_ptr<OptionButton>> subdivisionButtons;
+  std::vector<std::unique_ptr<OptionButton>> renderModeButtons;
+  std::vector<std::unique_ptr<OptionButton>> polyrhythmButtons;
 
   juce::Slider beatsPerBarSlider;
   juce::Slider volumeSlider;
   juce::TextButton closeButton;
+  OptionButton frameStatsButton { "Frame stats" };
 
   ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
+  juce::uint32 themeGeneration = 0;
+};
+
+//==============================================================================
+// Stats Overlay - frame timing percentiles from the editor's FrameProfiler, or the
+// processor's host timing report
+//==============================================================================
+class VizBeatsAudioProcessorEditor::StatsOverlay final : public juce::Component
+{
+public:
+  StatsOverlay(FrameProfiler& p, const QualityGovernor& q, HostTimingProfiler& h)
+      : profiler(p), governor(q), hostTiming(h)
+  {
+    exportButton.setButtonText("Export CSV");
+    exportButton.onClick = [this] { exportCsv(); };
+    addAndMakeVisible(exportButton);
+
+    resetButton.setButtonText("Reset");
+    resetButton.onClick = [this]
+    {
+      if (showingHost)
+        hostTiming.reset();
+      else
+        profiler.reset();
+
+      status.clear();
+      refresh();
+    };
+    addAndMakeVisible(resetButton);
+
+    pageButton.setButtonText("Host");
+    pageButton.onClick = [this]
+    {
+      showingHost = !showingHost;
+      pageButton.setButtonText(showingHost ? "Frames" : "Host");
+      status.clear();
+      refresh();
+    };
+    addAndMakeVisible(pageButton);
+
+    // Process-wide capture: every instance's audio, message and render threads.
+    traceButton.setButtonText(TraceRecorder::isRecording() ? "Stop" : "Trace");
+    traceButton.onClick = [this] { toggleTrace(); };
+    addAndMakeVisible(traceButton);
+
+    setInterceptsMouseClicks(false, true);
+  }
+
+  void setColors(const ThemeColors& colors, juce::uint32 generation)
+  {
+    if (generation == themeGeneration)
+      return;
+
+    themeGeneration = generation;
+    theme = colors;
+    repaint();
+  }
+
+  // Rebuilds the summary text; only repaints when it actually changed.
+  void refresh()
+  {
+    juce::StringArray newLines;
+
+    if (showingHost)
+    {
+      newLines = hostTiming.getSummaryLines();
+      if (status.isNotEmpty())
+        newLines.add(status);
+
+      setLines(std::move(newLines));
+      return;
+    }
+
+    const auto addChannel = [this, &newLines](const char* label, FrameProfiler::Channel channel)
+    {
+      const auto stats = profiler.getStats(channel);
+      newLines.add(juce::String(label).paddedRight(' ', 9)
+                   + juce::String(stats.p50Ms, 2).paddedLeft(' ', 7)
+                   + juce::String(stats.p95Ms, 2).paddedLeft(' ', 7)
+                   + juce::String(stats.p99Ms, 2).paddedLeft(' ', 7));
+    };
+
+    newLines.add(juce::String("ms").paddedRight(' ', 9) + "    p50    p95    p99");
+    addChannel("frame", FrameProfiler::Channel::FrameCallback);
+    addChannel("interval", FrameProfiler::Channel::FrameInterval);
+    addChannel("traffic", FrameProfiler::Channel::TrafficPaint);
+    addChannel("mode", FrameProfiler::Channel::ModePaint);
+    newLines.add("dropped " + juce::String(static_cast<juce::int64>(profiler.getDroppedFrames()))
+                 + "  late " + juce::String(static_cast<juce::int64>(profiler.getLateCallbacks()))
+                 + "  @" + juce::String(1.0 / profiler.getRefreshPeriodSeconds(), 0) + " Hz");
+    newLines.add("quality " + juce::String(QualityGovernor::getLevelName(governor.getLevel()))
+                 + "  (" + juce::String(governor.getAveragePaintSeconds() * 1000.0, 2) + " ms)");
+
+    if (status.isNotEmpty())
+      newLines.add(status);
+
+    setLines(std::move(newLines));
+  }
+
+  void paint(juce::Graphics& g) override
+  {
+    const ScopedTrace trace("StatsOverlay::paint");
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(theme.panelBg.withAlpha(0.88f));
+    g.fillRoundedRectangle(bounds, 10.0f);
+
+    g.setColour(theme.textPrimary.withAlpha(0.92f));
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+
+    auto textArea = getLocalBounds().reduced(10, 8);
+    textArea.removeFromBottom(28);
+    for (const auto& line : lines)
+      g.drawText(line, textArea.removeFromTop(15), juce::Justification::centredLeft, false);
+  }
+
+  void resized() override
+  {
+    auto buttons = getLocalBounds().reduced(10, 6).removeFromBottom(24);
+    exportButton.setBounds(buttons.removeFromLeft(76));
+    buttons.removeFromLeft(6);
+    resetButton.setBounds(buttons.removeFromLeft(54));
+    buttons.removeFromLeft(6);
+    pageButton.setBounds(buttons.removeFromLeft(60));
+    buttons.removeFromLeft(6);
+    traceButton.setBounds(buttons.removeFromLeft(60));
+  }
+
+private:
+  void setLines(juce::StringArray newLines)
+  {
+    if (newLines != lines)
+    {
+      lines = std::move(newLines);
+      repaint();
+    }
+  }
+
+  void exportCsv()
+  {
+    const auto file = makeDiagnosticsFile(showingHost ? "host-timing" : "frame-stats", ".csv");
+    const bool saved = showingHost ? hostTiming.writeCsv(file) : profiler.writeCsv(file);
+    status = saved ? "saved " + file.getFileName() : juce::String("export failed");
+    refresh();
+  }
+
+  void toggleTrace()
+  {
+    auto& recorder = TraceRecorder::getInstance();
+
+    if (!TraceRecorder::isRecording())
+    {
+      recorder.start();
+      traceButton.setButtonText("Stop");
+      status = "tracing...";
+      refresh();
+      return;
+    }
+
+    recorder.stop();
+    traceButton.setButtonText("Trace");
+
+    const auto file = makeDiagnosticsFile("trace", ".json");
+    status = recorder.writeJson(file) ? "saved " + file.getFileName() : juce::String("trace export failed");
+    refresh();
+  }
+
+  FrameProfiler& profiler;
+  const QualityGovernor& governor;
+  HostTimingProfiler& hostTiming;
+  bool showingHost = false;
+  juce::StringArray lines;
+  juce::String status;
+
+  juce::TextButton exportButton;
+  juce::TextButton resetButton;
+  juce::TextButton pageButton;
+  juce::TextButton traceButton;
+
+  ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
+  juce::uint32 themeGeneration = 0;
 };
 
 //==============================================================================
@@ -1074,7 +1071,7 @@ class VizBeatsAudioProcessorEditor::TransportBar final : public juce::Component
 public:
   explicit TransportBar(VizBeatsAudioProcessor& p)
       : processor(p),
-        settingsButton(makeGearPath()),
+        settingsButton(&EditorIcons::gear),
         minusButton("-"),
         plusButton("+")
   {
@@ -1082,6 +1079,7 @@ public:
     addAndMakeVisible(minusButton);
     addAndMakeVisible(plusButton);
     addAndMakeVisible(bpmReadout);
+    addAndMakeVisible(dspLoadReadout);
     addAndMakeVisible(playPauseButton);
 
     settingsButton.setTooltip("Settings");
@@ -1091,6 +1089,7 @@ public:
 
     minusButton.onClick = [this] { nudgeManualBpm(-1.0f); };
     plusButton.onClick = [this] { nudgeManualBpm(1.0f); };
+    dspLoadReadout.onResetPeak = [this] { processor.resetPeakDspLoad(); };
 
     playPauseButton.onClick = [this]
     {
@@ -1106,6 +1105,9 @@ public:
 
   void setHostPlaying(bool isHostPlaying)
   {
+    if (isHostPlaying == hostPlaying)
+      return;
+
     hostPlaying = isHostPlaying;
     playPauseButton.setEnabled(!hostPlaying);
     repaint();
@@ -1127,16 +1129,32 @@ public:
     bpmReadout.setBpm(bpm);
   }
 
-  void setColors(ThemeColors colors)
+  void setBarBeat(int bar, int beat)
+  {
+    bpmReadout.setBarBeat(bar, beat);
+  }
+
+  void setDspLoad(double average, double peak)
+  {
+    dspLoadReadout.setLoad(average, peak);
+  }
+
+  void setColors(const ThemeColors& colors, juce::uint32 generation)
   {
+    if (generation == themeGeneration)
+      return;
+
+    themeGeneration = generation;
     theme = colors;
     bpmReadout.setColors(colors.textPrimary, colors.textMuted);
+    dspLoadReadout.setColors(colors.textPrimary, colors.textMuted);
     playPauseButton.setAccentColor(colors.accent);
     repaint();
   }
 
   void paint(juce::Graphics& g) override
   {
+    const ScopedTrace trace("TransportBar::paint");
     auto bounds = getLocalBounds().toFloat();
     const auto radius = bounds.getHeight() * 0.50f;
 
@@ -1154,8 +1172,10 @@ public:
     auto right = bounds.removeFromRight(height);
     playPauseButton.setBounds(right.reduced(12));
 
-    // Separator space
-    bounds.removeFromRight(20);
+    // DSP load between the BPM controls and the play button
+    bounds.removeFromRight(8);
+    dspLoadReadout.setBounds(bounds.removeFromRight(76).reduced(0, 18));
+    bounds.removeFromRight(12);
 
     // Settings button on the left with proper padding
     bounds.removeFromLeft(16);
@@ -1214,10 +1234,12 @@ private:
   StepButton minusButton;
   StepButton plusButton;
   BpmReadout bpmReadout;
+  DspLoadReadout dspLoadReadout;
   PlayPauseButton playPauseButton;
 
   bool hostPlaying = false;
   ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
+  juce::uint32 themeGeneration = 0;
 };
 
 //==============================================================================
@@ -1232,54 +1254,169 @@ VizBeatsAudioProcessorEditor::VizBeatsAudioProcessorEditor(VizBeatsAudioProcesso
   setResizable(true, true);
   setResizeLimits(520, 320, 1920, 1080);
 
-  pulseVisualizer = std::make_unique<PulseVisualizer>();
-  trafficVisualizer = std::make_unique<TrafficVisualizer>();
+  // Visualizers and the settings panel are built on first use (see updateVisualizerVisibility
+  // and ensureSettingsPanel) so opening the editor only pays for what is actually shown.
   transportBar = std::make_unique<TransportBar>(processor);
-  settingsPanel = std::make_unique<SettingsPanel>(processor);
-
-  addAndMakeVisible(*pulseVisualizer);
-  addAndMakeVisible(*trafficVisualizer);
   addAndMakeVisible(*transportBar);
-  addChildComponent(*settingsPanel);
 
-  transportBar->onSettingsClick = [this]
-  {
-    settingsVisible = !settingsVisible;
-    settingsPanel->setVisible(settingsVisible);
-    if (settingsVisible)
-      settingsPanel->refreshFromProcessor();
-    resized();
-  };
-
-  settingsPanel->onClose = [this]
-  {
-    settingsVisible = false;
-    settingsPanel->setVisible(false);
-    resized();
-  };
+  transportBar->onSettingsClick = [this] { setSettingsVisible(!settingsVisible); };
 
+  colorThemeState.set(processor.getColorTheme());
+  transportBar->setColors(getThemeColors(colorThemeState.get()), colorThemeState.getGeneration());
+  activeVisualMode = processor.getVisualMode();
+  renderMode = static_cast<RenderMode>(juce::jlimit(0, 2, static_cast<int>(processor.apvts.state.getProperty(kRenderModePropertyId, 0))));
   updateVisualizerVisibility();
 
   setSize(960, 540);
-  startTimerHz(60);
+
+  frameClock->addClient(*this, *this);
 }
 
 VizBeatsAudioProcessorEditor::~VizBeatsAudioProcessorEditor()
 {
-  stopTimer();
+  frameClock->removeClient(*this);
+
+  // Children hold raw pointers to frameProfiler and qualityGovernor, which are declared after
+  // them. Release them first, so the render thread is stopped before the profiler goes away.
+  threadedTrafficView.reset();
+  trafficVisualizer.reset();
+  for (auto& modeVisualizer : modeVisualizers)
+    modeVisualizer.reset();
+  statsOverlay.reset();
+  settingsPanel.reset();
+  transportBar.reset();
 }
 
 void VizBeatsAudioProcessorEditor::updateVisualizerVisibility()
 {
-  if (pulseVisualizer != nullptr)
-    pulseVisualizer->setVisible(false);
+  const bool wantsOtherMode = activeVisualMode != VisualMode::Traffic;
+  const bool wantsThreadedTraffic = !wantsOtherMode && renderMode == RenderMode::RenderThread;
+  const bool wantsTraffic = !wantsOtherMode && !wantsThreadedTraffic;
+
+  auto& modeVisualizer = modeVisualizers[static_cast<size_t>(activeVisualMode)];
+  if (wantsOtherMode && modeVisualizer == nullptr)
+  {
+    modeVisualizer = std::make_unique<ModeVisualizer>(createBeatModeRenderer(activeVisualMode));
+    modeVisualizer->setProfiler(&frameProfiler);
+    modeVisualizer->setQualityGovernor(&qualityGovernor);
+    modeVisualizer->setColors(getThemeColors(colorThemeState.get()), colorThemeState.getGeneration());
+    addChildComponent(*modeVisualizer);
+    modeVisualizer->toBehind(transportBar.get());
+    resized();
+  }
+
+  if (wantsTraffic && trafficVisualizer == nullptr)
+  {
+    trafficVisualizer = std::make_unique<TrafficVisualizer>();
+    trafficVisualizer->setProfiler(&frameProfiler);
+    trafficVisualizer->setQualityGovernor(&qualityGovernor);
+    trafficVisualizer->setColors(getThemeColors(colorThemeState.get()), colorThemeState.getGeneration());
+    addChildComponent(*trafficVisualizer);
+    trafficVisualizer->toBehind(transportBar.get());
+    resized();
+  }
+
+  if (wantsThreadedTraffic && threadedTrafficView == nullptr)
+  {
+    threadedTrafficView = std::make_unique<ThreadedTrafficView>();
+    threadedTrafficView->setProfiler(&frameProfiler);
+    threadedTrafficView->setQualityGovernor(&qualityGovernor);
+    lastThreadedFrameSerial = 0;
+    addChildComponent(*threadedTrafficView);
+    threadedTrafficView->toBack(); // below the transport bar, stats overlay and settings panel
+    resized();
+  }
+
+  // The render thread only lives while its view is in use.
+  if (!wantsThreadedTraffic)
+    threadedTrafficView.reset();
+
+  // Tiled rendering splits large message-thread frames across a worker pool.
+  const bool wantsTiles = wantsTraffic && renderMode == RenderMode::Tiled;
+  if (wantsTiles && tiledRenderer == nullptr)
+    tiledRenderer = std::make_unique<TiledRenderer>();
+
   if (trafficVisualizer != nullptr)
-    trafficVisualizer->setVisible(true);
+    trafficVisualizer->setTiledRenderer(wantsTiles ? tiledRenderer.get() : nullptr);
+
+  if (!wantsTiles)
+    tiledRenderer.reset();
+
+  for (size_t i = 0; i < modeVisualizers.size(); ++i)
+    if (modeVisualizers[i] != nullptr)
+      modeVisualizers[i]->setVisible(static_cast<size_t>(activeVisualMode) == i);
+  if (trafficVisualizer != nullptr)
+    trafficVisualizer->setVisible(wantsTraffic);
+  if (threadedTrafficView != nullptr)
+    threadedTrafficView->setVisible(wantsThreadedTraffic);
+}
+
+void VizBeatsAudioProcessorEditor::ensureSettingsPanel()
+{
+  if (settingsPanel != nullptr)
+    return;
+
+  settingsPanel = std::make_unique<SettingsPanel>(processor);
+  settingsPanel->setColors(getThemeColors(colorThemeState.get()), colorThemeState.getGeneration());
+  settingsPanel->onClose = [this] { setSettingsVisible(false); };
+  settingsPanel->onFrameStatsToggled = [this](bool shown) { setFrameStatsVisible(shown); };
+  settingsPanel->onRenderModeChanged = [this](RenderMode mode) { setRenderMode(mode); };
+  addChildComponent(*settingsPanel);
+}
+
+void VizBeatsAudioProcessorEditor::setSettingsVisible(bool shouldBeVisible)
+{
+  settingsVisible = shouldBeVisible;
+
+  if (settingsVisible)
+  {
+    ensureSettingsPanel();
+    settingsPanel->setColors(getThemeColors(colorThemeState.get()), colorThemeState.getGeneration());
+    settingsPanel->refreshFromProcessor();
+    settingsPanel->setFrameStatsShown(statsOverlay != nullptr && statsOverlay->isVisible());
+    settingsPanel->setRenderModeShown(renderMode);
+  }
+
+  if (settingsPanel != nullptr)
+    settingsPanel->setVisible(settingsVisible);
+
+  resized();
+  repaint();
+}
+
+void VizBeatsAudioProcessorEditor::setFrameStatsVisible(bool shouldBeVisible)
+{
+  if (shouldBeVisible && statsOverlay == nullptr)
+  {
+    statsOverlay = std::make_unique<StatsOverlay>(frameProfiler, qualityGovernor, processor.getHostTimingProfiler());
+    statsOverlay->setColors(getThemeColors(colorThemeState.get()), colorThemeState.getGeneration());
+    addChildComponent(*statsOverlay);
+    statsOverlay->toBehind(transportBar.get());
+    resized();
+  }
+
+  if (statsOverlay != nullptr)
+  {
+    statsOverlay->setVisible(shouldBeVisible);
+    if (shouldBeVisible)
+      statsOverlay->refresh();
+  }
+}
+
+void VizBeatsAudioProcessorEditor::setRenderMode(RenderMode newMode)
+{
+  if (newMode == renderMode)
+    return;
+
+  renderMode = newMode;
+  processor.apvts.state.setProperty(kRenderModePropertyId, static_cast<int>(renderMode), nullptr);
+  updateVisualizerVisibility();
 }
 
 void VizBeatsAudioProcessorEditor::paint(juce::Graphics& g)
 {
-  const auto theme = getThemeColors(processor.getColorTheme());
+  const ScopedTrace trace("Editor::paint");
+  const auto& theme = getThemeColors(colorThemeState.get());
   auto bounds = getLocalBounds().toFloat();
 
   // Uniform background - single color, no gradients
@@ -1308,134 +1445,235 @@ void VizBeatsAudioProcessorEditor::resized()
   // Make visualizers cover the full area above the transport bar
   // They will handle their own internal margins
   auto vizBounds = bounds.withTrimmedBottom(barHeight + 18);
-  if (pulseVisualizer != nullptr)
-    pulseVisualizer->setBounds(vizBounds);
+  for (auto& modeVisualizer : modeVisualizers)
+    if (modeVisualizer != nullptr)
+      modeVisualizer->setBounds(vizBounds);
 
   if (trafficVisualizer != nullptr)
     trafficVisualizer->setBounds(vizBounds);
 
-  // Settings panel - centered
+  if (threadedTrafficView != nullptr)
+    threadedTrafficView->setBounds(vizBounds);
+
+  if (statsOverlay != nullptr)
+    statsOverlay->setBounds(vizBounds.getX() + 12, vizBounds.getY() + 12, 290, 165);
+
+  // Settings panel - centered. Tall enough for every section; in a smaller editor the
+  // sections scroll.
   if (settingsPanel != nullptr)
   {
     const auto panelWidth = juce::jmin(450, bounds.getWidth() - 40);
-    const auto panelHeight = juce::jmin(480, bounds.getHeight() - 40);
+    const auto panelHeight = juce::jmin(720, bounds.getHeight() - 40);
     const auto panelX = (bounds.getWidth() - panelWidth) / 2;
     const auto panelY = (bounds.getHeight() - panelHeight) / 2;
     settingsPanel->setBounds(panelX, panelY, panelWidth, panelHeight);
   }
 }
 
-void VizBeatsAudioProcessorEditor::timerCallback()
+VizBeatsAudioProcessorEditor::FrameInputs VizBeatsAudioProcessorEditor::captureFrameInputs() const
 {
-  const auto hostInfo = processor.getHostInfo();
-  const auto manualBpm = static_cast<double>(processor.apvts.getRawParameterValue(kManualBpmParamId)->load());
-  const auto internalPlay = processor.apvts.getRawParameterValue(kInternalPlayParamId)->load() > 0.5f;
-  const auto beatsPerBar = processor.getBeatsPerBar();
-  const auto subdivisions = processor.getSubdivisions();
-  const auto currentTheme = processor.getColorTheme();
-  const auto activeTheme = getThemeColors(currentTheme);
+  FrameInputs inputs;
+  inputs.play = processor.getPlayInfo();
+  inputs.manualBpm = processor.getManualBpm();
+  inputs.internalPlay = processor.getInternalPlay();
+  inputs.beatsPerBar = processor.getBeatsPerBar();
+  inputs.subdivisions = processor.getSubdivisions();
+  inputs.colorTheme = processor.getColorTheme();
+  inputs.visualMode = processor.getVisualMode();
+  inputs.lanes = processor.getPolyrhythmLanes();
+  return inputs;
+}
 
-  // Check if theme changed and repaint entire editor
-  if (currentTheme != lastColorTheme)
+void VizBeatsAudioProcessorEditor::frameClockTick(double nowSeconds)
+{
+  // Frames are driven by the display's vblank (through the shared frame clock) so 120/144 Hz
+  // screens get every refresh. Nothing is drawn while the editor is hidden or minimised.
+  if (isShowing())
+    runFrame(nowSeconds);
+}
+
+void VizBeatsAudioProcessorEditor::runFrame(double nowSeconds)
+{
+  if (nowSeconds - lastDspLoadRefreshSeconds >= kDspLoadRefreshIntervalSeconds)
   {
-    lastColorTheme = currentTheme;
-    repaint(); // Repaint the entire editor
+    lastDspLoadRefreshSeconds = nowSeconds;
+    transportBar->setDspLoad(processor.getDspLoad(), processor.getPeakDspLoad());
   }
 
-  // Track when internal play or host play starts for timing fallback
-  if ((internalPlay && !lastInternalPlayState) || (hostInfo.isPlaying && !lastHostPlayingState))
-    internalStartTimeSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001;
+  // Stopped and settled: a frame would only redraw the same state, so it runs only once
+  // something it reads has changed (or the render thread finished a frame to show).
+  const auto inputs = captureFrameInputs();
+  const bool inputsChanged = inputs != lastFrameInputs;
+  lastFrameInputs = inputs;
 
-  lastInternalPlayState = internalPlay;
-  lastHostPlayingState = hostInfo.isPlaying;
+  const bool threadedFramePending = threadedTrafficView != nullptr && threadedTrafficView->getCompletedFrameSerial() != lastThreadedFrameSerial;
 
-  const auto hostPlaying = hostInfo.isPlaying;
+  if (frameIdle && !inputsChanged && !threadedFramePending)
+  {
+    refreshStatsOverlay(nowSeconds);
+    return;
+  }
 
-  // Always prefer host BPM when available, regardless of host playing state
-  // This shows the project tempo even when stopped
-  const auto effectiveBpm = hostInfo.hasBpm ? hostInfo.bpm : manualBpm;
+  // Last step of the quality governor: thin out vblanks to a lower frame rate. The tolerance
+  // keeps vblank jitter from skipping an extra frame.
+  const auto maxFrameRateHz = qualityGovernor.getSettings().maxFrameRateHz;
+  const bool frameRateCapped = maxFrameRateHz > 0.0;
+  if (!frameIdle && frameRateCapped && nowSeconds - lastFrameTimeSeconds < 0.9 / maxFrameRateHz)
+    return;
 
-  // When host is playing, override internal play state for display
-  transportBar->setHostPlaying(hostPlaying);
-  transportBar->setPlayState(hostPlaying || internalPlay);
-  transportBar->setBpm(effectiveBpm);
-  transportBar->setColors(activeTheme);
-  if (settingsPanel != nullptr)
-    settingsPanel->setColors(activeTheme);
+  // Intervals are only meaningful between consecutive full-rate frames.
+  if (!frameIdle && !frameRateCapped && lastFrameTimeSeconds > 0.0)
+    frameProfiler.recordFrameInterval(nowSeconds - lastFrameTimeSeconds);
 
-  bool isRunning = false;
-  double beatPhase = 0.0;
+  lastFrameTimeSeconds = nowSeconds;
+  frameCallback();
+  refreshStatsOverlay(nowSeconds);
+}
 
-  // Host transport takes priority - when DAW is playing, sync to it
-  if (hostPlaying)
+void VizBeatsAudioProcessorEditor::refreshStatsOverlay(double nowSeconds)
+{
+  if (statsOverlay != nullptr && statsOverlay->isVisible() && nowSeconds - lastStatsRefreshSeconds >= kStatsRefreshIntervalSeconds)
   {
-    isRunning = true;
+    lastStatsRefreshSeconds = nowSeconds;
+    statsOverlay->setColors(getThemeColors(colorThemeState.get()), colorThemeState.getGeneration());
+    statsOverlay->refresh();
+  }
+}
 
-    if (hostInfo.hasPpqPosition)
-    {
-      const auto ppq = hostInfo.ppqPosition;
-      beatPhase = ppq - std::floor(ppq);
-      if (beatPhase < 0.0)
-        beatPhase += 1.0;
+bool VizBeatsAudioProcessorEditor::isVisualizerAnimating() const
+{
+  const auto& modeVisualizer = modeVisualizers[static_cast<size_t>(activeVisualMode)];
+  if (modeVisualizer != nullptr && modeVisualizer->isVisible() && modeVisualizer->isAnimating())
+    return true;
 
-      // Calculate current beat in bar from PPQ
-      currentBeatInBar = static_cast<int>(std::fmod(ppq, static_cast<double>(beatsPerBar)));
-    }
-    else
-    {
-      // Host playing but no PPQ - use time-based fallback with host BPM
-      const auto nowSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001;
-      const auto elapsedSeconds = juce::jmax(0.0, nowSeconds - internalStartTimeSeconds);
-      const auto useBpm = hostInfo.hasBpm ? hostInfo.bpm : effectiveBpm;
-      const auto beats = elapsedSeconds * (useBpm / 60.0);
-      beatPhase = beats - std::floor(beats);
-      currentBeatInBar = static_cast<int>(std::fmod(beats, static_cast<double>(beatsPerBar)));
-    }
-  }
-  else if (internalPlay)
-  {
-    // Only use internal play when host is NOT playing
-    isRunning = true;
-    const auto nowSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001;
-    const auto elapsedSeconds = juce::jmax(0.0, nowSeconds - internalStartTimeSeconds);
-    // Use project BPM if the host provides it even while stopped; fall back to manual BPM.
-    const auto beats = elapsedSeconds * (effectiveBpm / 60.0);
-    beatPhase = beats - std::floor(beats);
+  if (threadedTrafficView != nullptr && threadedTrafficView->isVisible() && threadedTrafficView->isAnimating())
+    return true;
+
+  return trafficVisualizer != nullptr && trafficVisualizer->isVisible() && trafficVisualizer->isAnimating();
+}
 
-    // Calculate current beat in bar
-    currentBeatInBar = static_cast<int>(std::fmod(beats, static_cast<double>(beatsPerBar)));
+void VizBeatsAudioProcessorEditor::frameCallback()
+{
+  const FrameProfiler::ScopedTimer frameTimer(&frameProfiler, FrameProfiler::Channel::FrameCallback);
+  const ScopedTrace trace("frameCallback");
+
+  const auto play = processor.getPlayInfo();
+  const auto& hostInfo = play.host;
+  const auto manualBpm = processor.getManualBpm();
+  const auto internalPlay = processor.getInternalPlay();
+  const auto beatsPerBar = processor.getBeatsPerBar();
+  const auto subdivisions = processor.getSubdivisions();
+
+  // Paint times from the previous frames decide this frame's quality level.
+  qualityGovernor.update();
+
+  // Theme, play state and BPM readout only propagate when their values actually change;
+  // components compare the theme generation so lazily created ones still catch up.
+  if (colorThemeState.set(processor.getColorTheme()))
+    repaint(); // Repaint the entire editor
+
+  const auto& activeTheme = getThemeColors(colorThemeState.get());
+  const auto themeGeneration = colorThemeState.getGeneration();
+
+  const auto visualMode = processor.getVisualMode();
+  if (visualMode != activeVisualMode)
+  {
+    activeVisualMode = visualMode;
+    updateVisualizerVisibility();
   }
 
-  bool beatWrapped = false;
+  const auto hostPlaying = hostInfo.isPlaying;
+
+  // Always prefer host BPM when available, regardless of host playing state
+  // This shows the project tempo even when stopped. While running, the readout shows the
+  // tempo the clicks play at (host, Manual BPM or the tempo map).
+  auto effectiveBpm = hostInfo.hasBpm ? hostInfo.bpm : manualBpm;
+  if (play.isRunning)
+    effectiveBpm = play.bpm;
+
+  // When host is playing, override internal play state for display
+  const bool hostPlayingChanged = hostPlayingState.set(hostPlaying);
+  const bool playStateChanged = playButtonState.set(hostPlaying || internalPlay);
+
+  if (hostPlayingChanged)
+    transportBar->setHostPlaying(hostPlaying);
+  if (hostPlayingChanged || playStateChanged)
+    transportBar->setPlayState(hostPlaying || internalPlay);
+  if (displayBpmState.set(juce::roundToInt(effectiveBpm)))
+    transportBar->setBpm(effectiveBpm);
+
+  transportBar->setColors(activeTheme, themeGeneration);
+  if (settingsPanel != nullptr && settingsPanel->isVisible())
+    settingsPanel->setColors(activeTheme, themeGeneration);
+
+  // Position and meter come from the audio thread for every phase source (host PPQ, host
+  // time, internal play, tempo map), resolved once per block where the clicks are scheduled.
+  const bool isRunning = play.isRunning;
+  const auto bar = isRunning ? play.bar : BarPosition::fromBeats(0.0, beatsPerBar);
+  double beatPhase = 0.0;
+
   if (isRunning)
   {
-    beatWrapped = lastUiRunning && (beatPhase < lastBeatPhaseUi);
-    lastBeatPhaseUi = static_cast<float>(beatPhase);
+    beatPhase = bar.getBeatPhase();
+    currentBeatInBar = bar.getBeatIndex();
+    currentBarNumber = static_cast<int>(bar.barIndex) + 1;
   }
   else
   {
-    lastBeatPhaseUi = 0.0f;
     currentBeatInBar = 0;
+    currentBarNumber = 1;
   }
+
+  transportBar->setBarBeat(currentBarNumber, currentBeatInBar + 1);
+
+  const bool runningChanged = isRunning != lastUiRunning;
   lastUiRunning = isRunning;
 
-  // Update visualizer visibility based on mode
-  updateVisualizerVisibility();
+  // Stopped and settled: skip per-frame repaints (setters still repaint on real changes).
+  const bool needsFrame = isRunning || runningChanged || isVisualizerAnimating();
+
+  BeatFrameState frame;
+  frame.beatPhase = beatPhase;
+  frame.running = isRunning;
+  frame.beatsPerBar = bar.numerator;
+  frame.subdivisions = subdivisions;
+  frame.currentBeat = currentBeatInBar;
+  frame.barIndex = bar.barIndex;
+  frame.discontinuityGeneration = play.discontinuityGeneration;
+  frame.lanes = processor.getPolyrhythmLanes();
+  frame.frameTimeSeconds = lastFrameTimeSeconds;
+  frame.quality = qualityGovernor.getSettings();
+
+  // Only the visible visualizer gets per-frame work; hidden ones keep their last state.
+  auto& modeVisualizer = modeVisualizers[static_cast<size_t>(activeVisualMode)];
+  if (modeVisualizer != nullptr && modeVisualizer->isVisible())
+  {
+    modeVisualizer->setColors(activeTheme, themeGeneration);
+    modeVisualizer->applyFrameState(frame);
+    if (needsFrame)
+      modeVisualizer->repaint();
+  }
+
+  if (trafficVisualizer != nullptr && trafficVisualizer->isVisible())
+  {
+    trafficVisualizer->setColors(activeTheme, themeGeneration);
+    trafficVisualizer->applyFrameState(frame);
+    if (needsFrame)
+      trafficVisualizer->repaint();
+  }
+
+  if (threadedTrafficView != nullptr && threadedTrafficView->isVisible())
+  {
+    threadedTrafficView->submit(frame, activeTheme, themeGeneration, needsFrame);
+
+    // Frames complete asynchronously; blit whichever one finished since the last vblank.
+    const auto serial = threadedTrafficView->getCompletedFrameSerial();
+    if (serial != lastThreadedFrameSerial)
+    {
+      lastThreadedFrameSerial = serial;
+      threadedTrafficView->repaint();
+    }
+  }
 
-  // Update pulse visualizer
-  pulseVisualizer->setRunning(isRunning);
-  pulseVisualizer->setPulse(isRunning ? (beatWrapped ? 1.0f : pulseFromBeatPhase(beatPhase)) : 0.0f);
-  pulseVisualizer->setColors(activeTheme);
-
-  // Update traffic visualizer
-  trafficVisualizer->setRunning(isRunning);
-  trafficVisualizer->setBeatPhase(beatPhase);
-  trafficVisualizer->setBeatsPerBar(beatsPerBar);
-  trafficVisualizer->setSubdivisions(subdivisions);
-  trafficVisualizer->setCurrentBeat(currentBeatInBar);
-  trafficVisualizer->setColors(activeTheme);
-
-  pulseVisualizer->repaint();
-  trafficVisualizer->repaint();
-  transportBar->repaint();
+  frameIdle = !needsFrame;
 }
@@ -1,11 +1,22 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FrameClock.h"
+#include "FrameProfiler.h"
+#include "QualityGovernor.h"
 #include "PluginProcessor.h"
+#include "TrackedValue.h"
+
+#include <array>
 
 class VizBeatsAudioProcessor;
+class ModeVisualizer;
+class ThreadedTrafficView;
+class TiledRenderer;
+class TrafficVisualizer;
 
-class VizBeatsAudioProcessorEditor final : public juce::AudioProcessorEditor, private juce::Timer
+class VizBeatsAudioProcessorEditor final : public juce::AudioProcessorEditor,
+                                           private FrameClock::Client
 {
 public:
   explicit VizBeatsAudioProcessorEditor(VizBeatsAudioProcessor&);
@@ -14,30 +25,93 @@ public:
   void paint(juce::Graphics&) override;
   void resized() override;
 
+  // One frame as the frame clock runs it, but also while the editor isn't showing. Lets
+  // offscreen benchmarks drive the full frame path without a display.
+  void runFrame(double nowSeconds);
+
 private:
-  void timerCallback() override;
+  // Where the traffic visualizer is rasterised. A UI preference stored as a property of the
+  // processor state, not an automatable parameter.
+  enum class RenderMode
+  {
+    MessageThread = 0,
+    RenderThread,
+    Tiled
+  };
+
+  // Everything frameCallback() reads from the processor. While idle, an unchanged snapshot
+  // means the frame can be skipped.
+  struct FrameInputs
+  {
+    VizBeatsAudioProcessor::PlayInfo play;
+    double manualBpm = 0.0;
+    bool internalPlay = false;
+    int beatsPerBar = 0;
+    int subdivisions = 0;
+    ColorTheme colorTheme = ColorTheme::HighContrast;
+    VisualMode visualMode = VisualMode::Traffic;
+    PolyrhythmLanes lanes;
+
+    bool operator==(const FrameInputs& other) const noexcept
+    {
+      return play == other.play && manualBpm == other.manualBpm && internalPlay == other.internalPlay
+             && beatsPerBar == other.beatsPerBar && subdivisions == other.subdivisions
+             && colorTheme == other.colorTheme && visualMode == other.visualMode && lanes == other.lanes;
+    }
+
+    bool operator!=(const FrameInputs& other) const noexcept { return !operator==(other); }
+  };
+
+  void frameClockTick(double nowSeconds) override;
+  FrameInputs captureFrameInputs() const;
+  void refreshStatsOverlay(double nowSeconds);
+  void frameCallback();
+  bool isVisualizerAnimating() const;
   void updateVisualizerVisibility();
+  void ensureSettingsPanel();
+  void setSettingsVisible(bool shouldBeVisible);
+  void setFrameStatsVisible(bool shouldBeVisible);
+  void setRenderMode(RenderMode newMode);
 
   VizBeatsAudioProcessor& processor;
 
-  class PulseVisualizer;
-  class TrafficVisualizer;
   class TransportBar;
   class SettingsPanel;
+  class StatsOverlay;
 
-  std::unique_ptr<PulseVisualizer> pulseVisualizer;
+  std::unique_ptr<TiledRenderer> tiledRenderer;
+  // One per non-traffic mode (indexed by VisualMode), created on first use and kept so
+  // switching back is instant with the cached layers intact.
+  std::array<std::unique_ptr<ModeVisualizer>, 6> modeVisualizers;
   std::unique_ptr<TrafficVisualizer> trafficVisualizer;
+  std::unique_ptr<ThreadedTrafficView> threadedTrafficView;
   std::unique_ptr<TransportBar> transportBar;
   std::unique_ptr<SettingsPanel> settingsPanel;
+  std::unique_ptr<StatsOverlay> statsOverlay;
+
+  FrameProfiler frameProfiler;
+  QualityGovernor qualityGovernor;
+  double lastStatsRefreshSeconds = 0.0;
+  double lastDspLoadRefreshSeconds = 0.0;
 
   bool settingsVisible = false;
-  bool lastInternalPlayState = false;
-  bool lastHostPlayingState = false;
-  double internalStartTimeSeconds = 0.0;
-  float lastBeatPhaseUi = 0.0f;
   bool lastUiRunning = false;
   int currentBeatInBar = 0;
-  ColorTheme lastColorTheme = ColorTheme::HighContrast;
+  int currentBarNumber = 1;
+  VisualMode activeVisualMode = VisualMode::Traffic;
+  RenderMode renderMode = RenderMode::MessageThread;
+  juce::uint32 lastThreadedFrameSerial = 0;
+
+  TrackedValue<ColorTheme> colorThemeState;
+  TrackedValue<int> displayBpmState;
+  TrackedValue<bool> hostPlayingState;
+  TrackedValue<bool> playButtonState;
+
+  // Frame pacing: every vblank while something moves, only on input changes otherwise.
+  double lastFrameTimeSeconds = 0.0;
+  bool frameIdle = false;
+  FrameInputs lastFrameInputs;
+  juce::SharedResourcePointer<FrameClock> frameClock;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VizBeatsAudioProcessorEditor)
 };
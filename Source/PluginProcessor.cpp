@@ -1,7 +1,9 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "TraceRecorder.h"
 
 #include <cmath>
+#include <limits>
 
 namespace
 {
@@ -13,6 +15,16 @@ constexpr auto kBeatsPerBarParamId = "beatsPerBar";
 constexpr auto kSubdivisionsParamId = "subdivisions";
 constexpr auto kSoundVolumeParamId = "soundVolume";
 constexpr auto kPreviewSubdivisionsParamId = "previewSubdivisions";
+
+// Tempo changes smaller than this aren't logged, so a tempo ramp logs a line per step, not per block.
+constexpr double kLoggedTempoStepBpm = 0.5;
+
+// A host PPQ further than this from where the previous block predicted it is logged as a jump.
+constexpr double kPpqJumpToleranceBeats = 0.01;
+
+// Two beat boundaries never land this close together, so a click this soon after the last one
+// is the same boundary seen again from the next block.
+constexpr juce::int64 kDuplicateClickSamples = 2;
 }
 
 VizBeatsAudioProcessor::VizBeatsAudioProcessor()
@@ -21,6 +33,16 @@ VizBeatsAudioProcessor::VizBeatsAudioProcessor()
                                .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
+  // Resolve raw parameter values once; the getters run on the audio thread every block
+  // and on the message thread every frame.
+  manualBpmParam = apvts.getRawParameterValue(kManualBpmParamId);
+  internalPlayParam = apvts.getRawParameterValue(kInternalPlayParamId);
+  visualModeParam = apvts.getRawParameterValue(kVisualModeParamId);
+  colorThemeParam = apvts.getRawParameterValue(kColorThemeParamId);
+  beatsPerBarParam = apvts.getRawParameterValue(kBeatsPerBarParamId);
+  subdivisionsParam = apvts.getRawParameterValue(kSubdivisionsParamId);
+  soundVolumeParam = apvts.getRawParameterValue(kSoundVolumeParamId);
+  previewSubdivisionsParam = apvts.getRawParameterValue(kPreviewSubdivisionsParamId);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout VizBeatsAudioProcessor::createParameterLayout()
@@ -78,44 +100,51 @@ juce::AudioProcessorValueTreeState::ParameterLayout VizBeatsAudioProcessor::crea
 
 VisualMode VizBeatsAudioProcessor::getVisualMode() const
 {
-  auto* param = apvts.getRawParameterValue(kVisualModeParamId);
-  juce::ignoreUnused(param);
-  // Only Traffic is supported/stable for production right now.
-  // Clamp to Traffic even if the stored state/automation requests another mode.
-  return VisualMode::Traffic;
+  const auto v = visualModeParam != nullptr ? static_cast<int>(visualModeParam->load()) : static_cast<int>(VisualMode::Traffic);
+  return static_cast<VisualMode>(juce::jlimit(0, static_cast<int>(VisualMode::Pattern), v));
+}
+
+double VizBeatsAudioProcessor::getManualBpm() const
+{
+  const auto v = manualBpmParam != nullptr ? static_cast<double>(manualBpmParam->load()) : 60.0;
+  return juce::jlimit(30.0, 300.0, v);
+}
+
+bool VizBeatsAudioProcessor::getInternalPlay() const
+{
+  return internalPlayParam != nullptr && internalPlayParam->load() > 0.5f;
 }
 
 ColorTheme VizBeatsAudioProcessor::getColorTheme() const
 {
-  auto* param = apvts.getRawParameterValue(kColorThemeParamId);
-  const auto v = param != nullptr ? static_cast<int>(param->load()) : 0;
+  const auto v = colorThemeParam != nullptr ? static_cast<int>(colorThemeParam->load()) : 0;
   return static_cast<ColorTheme>(juce::jlimit(0, 3, v));
 }
 
 int VizBeatsAudioProcessor::getBeatsPerBar() const
 {
-  auto* param = apvts.getRawParameterValue(kBeatsPerBarParamId);
+  auto* param = beatsPerBarParam;
   const auto v = param != nullptr ? static_cast<int>(param->load()) : 4;
   return juce::jlimit(1, 16, v);
 }
 
 int VizBeatsAudioProcessor::getSubdivisions() const
 {
-  auto* param = apvts.getRawParameterValue(kSubdivisionsParamId);
+  auto* param = subdivisionsParam;
   const auto v = param != nullptr ? static_cast<int>(param->load()) : 1;
   return juce::jlimit(1, 4, v);
 }
 
 float VizBeatsAudioProcessor::getSoundVolume() const
 {
-  auto* param = apvts.getRawParameterValue(kSoundVolumeParamId);
+  auto* param = soundVolumeParam;
   const auto v = param != nullptr ? param->load() : 0.5f;
   return juce::jlimit(0.0f, 1.0f, v);
 }
 
 bool VizBeatsAudioProcessor::getPreviewSubdivisions() const
 {
-  auto* param = apvts.getRawParameterValue(kPreviewSubdivisionsParamId);
+  auto* param = previewSubdivisionsParam;
   const auto v = param != nullptr ? param->load() : 0.0f;
   return v > 0.5f;
 }
@@ -173,19 +202,30 @@ void VizBeatsAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
   // Defensive: ensure valid sample rate
   sampleRateHz = sampleRate > 0.0 ? sampleRate : 44100.0;
 
-  const double bpm = juce::jmax(30.0, juce::jmin(300.0, hostBpm.load()));
-  internalSamplesPerBeat = sampleRateHz * (60.0 / bpm);
-  hostSamplesPerBeat = 0.0;
-  hostLastSamplePos = 0.0;
-  internalPhaseSamples = 0.0;
-  clickPhaseDelta = juce::MathConstants<double>::twoPi * clickFreqStart / sampleRateHz;
+  internalBeatPosition = 0.0;
+  processedSamples = 0;
+
+  if (clickTables == nullptr || clickTables->getSampleRate() != sampleRateHz)
+  {
+    const auto rate = sampleRateHz;
+    clickTables = clickTableCache->get(rate, [rate] { return std::make_shared<ClickTables>(rate); });
+  }
+
   resetClick();
-  juce::ignoreUnused(samplesPerBlock);
+  hostTiming.recordPrepare();
+  loadMeasurer.reset(sampleRateHz, samplesPerBlock);
+  resetPeakDspLoad();
+
+  preparedBlockSize = samplesPerBlock;
+  largestBlockSize = samplesPerBlock;
+  setPhaseSource(BeatPhaseSource::None);
+  rtLog.log(RtLogEvent::Prepare, sampleRateHz, 0.0, samplesPerBlock);
 }
 
 void VizBeatsAudioProcessor::releaseResources()
 {
   resetClick();
+  rtLog.log(RtLogEvent::Release);
 }
 
 bool VizBeatsAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -210,193 +250,170 @@ bool VizBeatsAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
   return mainIn == mainOut;
 }
 
-void VizBeatsAudioProcessor::updateHostInfo()
+VizBeatsAudioProcessor::BlockPosition VizBeatsAudioProcessor::readBlockPosition(int numSamples, bool realtime, int beatsPerBar)
 {
-  bool isPlaying = false;
+  BlockPosition block;
+  auto& info = block.host;
 
-  bool hasBpm = false;
-  double bpm = 120.0;
+  juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+  if (auto* playHead = getPlayHead())
+    position = playHead->getPosition();
 
-  bool hasPpqPosition = false;
-  double ppqPosition = 0.0;
+  // Callback timing means nothing while the host renders offline.
+  if (realtime)
+    hostTiming.recordBlock(position ? &*position : nullptr, numSamples, sampleRateHz);
 
-  if (auto* playHead = getPlayHead())
+  if (position)
   {
-    if (auto position = playHead->getPosition())
-    {
-      isPlaying = position->getIsPlaying();
+    info.isPlaying = position->getIsPlaying();
 
-      // Get BPM from host
-      if (auto optBpm = position->getBpm())
+    // Get BPM from host
+    if (auto optBpm = position->getBpm())
+    {
+      const double hostBpmValue = *optBpm;
+      // Accept any reasonable BPM value
+      if (std::isfinite(hostBpmValue) && hostBpmValue >= 1.0 && hostBpmValue <= 999.0)
       {
-        const double hostBpmValue = *optBpm;
-        // Accept any reasonable BPM value
-        if (std::isfinite(hostBpmValue) && hostBpmValue >= 1.0 && hostBpmValue <= 999.0)
-        {
-          bpm = hostBpmValue;
-          hasBpm = true;
-        }
+        info.bpm = hostBpmValue;
+        info.hasBpm = true;
       }
+    }
 
-      // Get PPQ position
-      if (auto optPpq = position->getPpqPosition())
-      {
-        ppqPosition = *optPpq;
-        hasPpqPosition = std::isfinite(ppqPosition);
-      }
+    // Get PPQ position
+    if (auto optPpq = position->getPpqPosition())
+    {
+      info.ppqPosition = *optPpq;
+      info.hasPpqPosition = std::isfinite(info.ppqPosition);
+    }
+
+    // Bar and beat, once per block, from the host's meter and bar start where it has them.
+    if (info.hasPpqPosition)
+      info.bar = BarPosition::fromPpq(info.ppqPosition, position->getTimeSignature(),
+                                      position->getPpqPositionOfLastBarStart(), position->getBarCount(), beatsPerBar);
+
+    if (auto timeSeconds = position->getTimeInSeconds())
+    {
+      block.timeInSeconds = *timeSeconds;
+      block.hasTimeInSeconds = std::isfinite(block.timeInSeconds);
+    }
+
+    if (auto timeSamples = position->getTimeInSamples())
+    {
+      block.timeInSamples = *timeSamples;
+      block.hasTimeInSamples = true;
+    }
+
+    if (auto loopPoints = position->getLoopPoints())
+    {
+      block.isLooping = position->getIsLooping() && std::isfinite(loopPoints->ppqStart) && std::isfinite(loopPoints->ppqEnd);
+      block.loopStartPpq = loopPoints->ppqStart;
+      block.loopEndPpq = loopPoints->ppqEnd;
     }
   }
 
-  hostIsPlaying.store(isPlaying, std::memory_order_relaxed);
-  hostHasBpm.store(hasBpm, std::memory_order_relaxed);
-  hostBpm.store(bpm, std::memory_order_relaxed);
-  hostHasPpqPosition.store(hasPpqPosition, std::memory_order_relaxed);
-  hostPpqPosition.store(ppqPosition, std::memory_order_relaxed);
+  return block;
 }
 
-VizBeatsAudioProcessor::HostInfo VizBeatsAudioProcessor::getHostInfo() const noexcept
+// Bar and beat at the block's first sample, from whichever source drives the clicks.
+BarPosition VizBeatsAudioProcessor::getBlockBar(const BlockPosition& block, const BeatClock& clock) noexcept
 {
-  HostInfo info;
-  info.isPlaying = hostIsPlaying.load(std::memory_order_relaxed);
-  info.hasBpm = hostHasBpm.load(std::memory_order_relaxed);
-  info.bpm = hostBpm.load(std::memory_order_relaxed);
-  info.hasPpqPosition = hostHasPpqPosition.load(std::memory_order_relaxed);
-  info.ppqPosition = hostPpqPosition.load(std::memory_order_relaxed);
-  return info;
-}
+  if (phaseSource == BeatPhaseSource::HostPpq)
+    return block.host.bar;
 
-void VizBeatsAudioProcessor::refreshHostInfo()
-{
-  // Try to update from playhead - this may work from message thread in some hosts
-  if (auto* playHead = getPlayHead())
+  if (phaseSource == BeatPhaseSource::TempoMap)
   {
-    if (auto position = playHead->getPosition())
-    {
-      const bool isPlaying = position->getIsPlaying();
+    // Before tempoMapSample moves on past this block.
+    const auto seconds = static_cast<double>(tempoMapSample) / sampleRateHz;
+    const auto& segment = tempoMapCursor.seek(seconds);
+    return TempoMap::getBarPosition(segment, segment.beatAtSeconds(seconds));
+  }
 
-      // Update playing state
-      hostIsPlaying.store(isPlaying, std::memory_order_relaxed);
+  // The other clocks count beatsPerBar quarter notes per bar.
+  return BarPosition::fromBeats(clock.beatPosition, clock.beatsPerBar);
+}
 
-      // Get BPM if available
-      if (auto optBpm = position->getBpm())
-      {
-        const double bpmVal = *optBpm;
-        if (std::isfinite(bpmVal) && bpmVal >= 1.0 && bpmVal <= 999.0)
-        {
-          hostBpm.store(bpmVal, std::memory_order_relaxed);
-          hostHasBpm.store(true, std::memory_order_relaxed);
-        }
-      }
+void VizBeatsAudioProcessor::publishPlayInfo(const HostInfo& host, bool isRunning, const BeatClock& clock,
+                                             const BarPosition& bar) noexcept
+{
+  auto& info = playInfoBuffer.getWriteBuffer();
+  info.host = host;
+  info.isRunning = isRunning;
+  info.bpm = clock.beatsPerSample * 60.0 * sampleRateHz * bar.getQuartersPerBeat();
+  info.bar = bar;
+  info.discontinuityGeneration = discontinuityGeneration;
+  playInfoBuffer.publish();
+}
 
-      // Get PPQ position
-      if (auto optPpq = position->getPpqPosition())
-      {
-        const double ppq = *optPpq;
-        if (std::isfinite(ppq))
-        {
-          hostPpqPosition.store(ppq, std::memory_order_relaxed);
-          hostHasPpqPosition.store(true, std::memory_order_relaxed);
-        }
-      }
-    }
-  }
+VizBeatsAudioProcessor::PlayInfo VizBeatsAudioProcessor::getPlayInfo() noexcept
+{
+  playInfoBuffer.update();
+  return playInfoBuffer.getReadBuffer();
 }
 
 void VizBeatsAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+  const ScopedTrace trace("processBlock");
+  const auto loadStartTicks = juce::Time::getHighResolutionTicks();
   juce::ScopedNoDenormals noDenormals;
   juce::ignoreUnused(midiMessages);
 
-  updateHostInfo();
-
-  const auto manualBpm = static_cast<double>(apvts.getRawParameterValue(kManualBpmParamId)->load());
-  const auto internalPlay = apvts.getRawParameterValue(kInternalPlayParamId)->load() > 0.5f;
-  const auto beatsPerBar = getBeatsPerBar();
-  const auto subdivisions = getSubdivisions();
-  const auto previewSubdivisions = getPreviewSubdivisions();
-  const auto hostInfo = getHostInfo();
-  const bool useInternalClock = internalPlay && !hostInfo.isPlaying;
-
-  double beatPhase = 0.0;
-  bool isRunning = false;
+  const auto numSamples = buffer.getNumSamples();
 
-  const bool hasPhase = computeBeatPhase(beatPhase, isRunning, manualBpm, internalPlay, buffer.getNumSamples());
+  // Offline bounce/freewheel: only sample-derived time, and nothing published to the editor.
+  const bool realtime = !isNonRealtime();
+  if (realtime != lastRealtime)
+  {
+    rtLog.log(RtLogEvent::RenderMode, 0.0, 0.0, realtime ? 0 : 1);
+    lastRealtime = realtime;
+    resetClick();
+  }
 
-  if (isRunning && hasPhase)
+  // A newly loaded tempo map plays from its start.
+  if (tempoMapBuffer.update())
   {
-    const bool phaseWrapped = lastBeatPhaseValid && (beatPhase < lastBeatPhase);
-    const bool shouldClick = !lastRunning || !lastBeatPhaseValid || phaseWrapped;
-    bool barWrapped = false;
+    activeTempoMap = tempoMapBuffer.getReadBuffer().get();
+    tempoMapCursor.reset(activeTempoMap);
+    tempoMapSample = 0;
+  }
 
-    // Different sound only when the ball reaches the right bar (bar wrap).
-    if (useInternalClock)
-    {
-      lastBarProgressValid = false;
-      lastBeatsPerBarForProgress = beatsPerBar;
+  if (polyrhythmBuffer.update())
+    polyrhythm.setLanes(polyrhythmBuffer.getReadBuffer());
 
-      if (!lastInternalPlay)
-        internalBeatCounter = 0;
+  const auto manualBpm = getManualBpm();
+  const auto internalPlay = getInternalPlay();
+  const auto beatsPerBar = getBeatsPerBar();
 
-      if (phaseWrapped)
-        ++internalBeatCounter;
+  const auto block = readBlockPosition(numSamples, realtime, beatsPerBar);
 
-      lastInternalPlay = true;
+  // Previewed subdivisions click between the beats, on the same sample-accurate schedule.
+  clickSubdivisions = getPreviewSubdivisions() ? getSubdivisions() : 1;
 
-      if (phaseWrapped && beatsPerBar > 0)
-        barWrapped = (internalBeatCounter % static_cast<int64_t>(beatsPerBar) == 0);
-    }
-    else
-    {
-      lastInternalPlay = false;
-      internalBeatCounter = 0;
+  const auto& hostInfo = block.host;
+  const auto bpm = hostInfo.hasBpm ? hostInfo.bpm : manualBpm;
 
-      if (hostInfo.isPlaying && hostInfo.hasPpqPosition && beatsPerBar > 0)
-      {
-        if (lastBeatsPerBarForProgress != beatsPerBar)
-        {
-          lastBeatsPerBarForProgress = beatsPerBar;
-          lastBarProgressValid = false;
-        }
-
-        const auto barBeats = static_cast<double>(beatsPerBar);
-        auto inBar = std::fmod(hostInfo.ppqPosition, barBeats);
-        if (inBar < 0.0)
-          inBar += barBeats;
-        const auto barProgress01 = inBar / barBeats;
-
-        if (lastBarProgressValid)
-          barWrapped = (barProgress01 + 0.15 < lastBarProgress01);
-
-        lastBarProgress01 = barProgress01;
-        lastBarProgressValid = true;
-      }
-      else
-      {
-        lastBeatsPerBarForProgress = beatsPerBar;
-        lastBarProgressValid = false;
-      }
-    }
+  // Blocks larger than prepareToPlay() promised: logged once per new maximum.
+  if (numSamples > largestBlockSize)
+  {
+    rtLog.log(RtLogEvent::OversizeBlock, preparedBlockSize, 0.0, numSamples);
+    largestBlockSize = numSamples;
+  }
 
-    if (shouldClick)
-      triggerClick(phaseWrapped && barWrapped);
+  BeatClock clock;
+  bool isRunning = false;
 
-    lastBeatPhase = beatPhase;
-    lastBeatPhaseValid = true;
-  }
-  else
+  const bool hasPhase = computeBeatPhase(clock, isRunning, block, manualBpm, beatsPerBar, internalPlay, numSamples, realtime);
+
+  // Resolved before the block moves the tempo map on; the editor shows this position.
+  BarPosition blockBar;
+  if (realtime)
   {
-    lastBeatPhaseValid = false;
-    lastBarProgressValid = false;
-    lastInternalPlay = false;
-    internalBeatCounter = 0;
-    lastSubdivPhaseValid = false;
+    hostTiming.recordPhaseSource(phaseSource);
+    if (isRunning)
+      blockBar = getBlockBar(block, clock);
   }
 
-  lastRunning = isRunning;
-
   const auto totalNumInputChannels = getTotalNumInputChannels();
   const auto totalNumOutputChannels = getTotalNumOutputChannels();
-  const auto numSamples = buffer.getNumSamples();
 
   // If no input channels (generator mode), clear output first
   if (totalNumInputChannels == 0)
@@ -415,19 +432,172 @@ void VizBeatsAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
   // We just add our click sound on top
 
   if (!isRunning)
-    clickSamplesLeft = 0;
+  {
+    activeClick = nullptr;
+    polyrhythm.stopVoices();
+  }
+
+  if (isRunning && hasPhase)
+  {
+    // A seek, or a loop the host didn't announce: forget the last click so a beat right at
+    // the new position plays now rather than being taken for a duplicate.
+    if (detectDiscontinuity(block, clock, realtime))
+    {
+      lastClickSampleValid = false;
+      polyrhythm.forgetLastPulses();
+      ++discontinuityGeneration;
+    }
+
+    // A loop end inside the block: the rest of the block already plays from the loop start.
+    int loopSample = numSamples;
+    BeatClock loopClock;
+    const bool loopWrapped = findLoopWrap(block, clock, numSamples, loopSample, loopClock);
+
+    if (phaseSource == BeatPhaseSource::TempoMap)
+    {
+      renderTempoMapClicks(buffer, numSamples, realtime);
+      tempoMapSample += numSamples;
+    }
+    else
+    {
+      renderBeatClicks(buffer, clock, 0, loopSample, realtime);
+    }
 
-  // Mix click sound into the output
-  if (isRunning)
-    renderClick(buffer);
+    if (loopWrapped)
+    {
+      rtLog.log(RtLogEvent::LoopWrap, block.loopEndPpq, block.loopStartPpq, loopSample);
+      ++discontinuityGeneration;
+      renderBeatClicks(buffer, loopClock, loopSample, numSamples, realtime);
+    }
+
+    const auto& endClock = loopWrapped ? loopClock : clock;
+    expectedBeatPosition = endClock.beatPosition + static_cast<double>(numSamples - (loopWrapped ? loopSample : 0)) * endClock.beatsPerSample;
+    expectedBeatPositionValid = true;
+
+    if (phaseSource == BeatPhaseSource::HostPpq)
+    {
+      const auto blockEndPpq = hostInfo.ppqPosition + static_cast<double>(numSamples) * bpm / (60.0 * sampleRateHz);
+      expectedPpq = loopWrapped ? blockEndPpq - (block.loopEndPpq - block.loopStartPpq) : blockEndPpq;
+      expectedPpqValid = hostInfo.hasBpm;
+    }
+  }
+  else
+  {
+    lastClickSampleValid = false;
+    polyrhythm.forgetLastPulses();
+    expectedPpqValid = false;
+    expectedBeatPositionValid = false;
+  }
+
+  // Published after the discontinuity check, so a jumped position arrives with its generation.
+  if (realtime)
+    publishPlayInfo(hostInfo, isRunning, clock, blockBar);
+
+  if (isRunning && !lastRunning)
+  {
+    const auto ppq = hostInfo.hasPpqPosition ? hostInfo.ppqPosition : std::numeric_limits<double>::quiet_NaN();
+    rtLog.log(RtLogEvent::TransportStart, bpm, ppq, static_cast<juce::int64>(phaseSource));
+    lastLoggedBpm = bpm;
+  }
+  else if (!isRunning && lastRunning)
+  {
+    rtLog.log(RtLogEvent::TransportStop);
+  }
+  else if (isRunning && std::abs(bpm - lastLoggedBpm) >= kLoggedTempoStepBpm)
+  {
+    rtLog.log(RtLogEvent::TempoChange, lastLoggedBpm, bpm);
+    lastLoggedBpm = bpm;
+  }
+
+  lastRunning = isRunning;
+  processedSamples += numSamples;
+
+  // Offline blocks don't run against the clock, so they say nothing about real-time load.
+  if (realtime)
+    recordDspLoad(loadStartTicks, numSamples);
 }
 
-bool VizBeatsAudioProcessor::computeBeatPhase(double& outPhase, bool& outRunning, double manualBpm, bool internalPlay, int numSamples)
+void VizBeatsAudioProcessor::renderBeatClicks(juce::AudioBuffer<float>& buffer, const BeatClock& clock, int startSample,
+                                              int endSample, bool realtime)
 {
+  int rendered = startSample;
+
+  if (clock.beatsPerSample > 0.0 && endSample > startSample)
+  {
+    // Every beat boundary in [startSample, endSample), rounded to its nearest sample, and the
+    // subdivisions between them while those are previewed. Counted in subdivision steps, so
+    // beats stay whole numbers. Boundaries in the last half sample belong to the next block,
+    // which looks half a sample back for them.
+    const auto stepsPerBeat = static_cast<double>(clickSubdivisions);
+    const auto stepsPerSample = clock.beatsPerSample * stepsPerBeat;
+    const auto position = clock.beatPosition * stepsPerBeat;
+    const auto halfSample = 0.5 * stepsPerSample;
+    const auto end = position + stepsPerSample * static_cast<double>(endSample - startSample) - halfSample;
+
+    for (auto step = std::ceil(position - halfSample); step < end; step += 1.0)
+    {
+      const auto offset = juce::jlimit(rendered, endSample - 1,
+                                       startSample + static_cast<int>(std::round((step - position) / stepsPerSample)));
+
+      // Host positions are rounded, so the same boundary can come up at both block edges.
+      const auto clickSample = processedSamples + offset;
+      if (lastClickSampleValid && clickSample - lastClickSample <= kDuplicateClickSamples)
+        continue;
+
+      renderClick(buffer, rendered, offset - rendered);
+      rendered = offset;
+
+      const auto stepIndex = static_cast<juce::int64>(step);
+      const auto onBeat = stepIndex % clickSubdivisions == 0;
+      const auto accent = onBeat && clock.beatsPerBar > 0 && (stepIndex / clickSubdivisions) % clock.beatsPerBar == 0;
+
+      if (onBeat)
+        triggerClick(accent);
+      else
+        triggerSubdivisionClick();
+
+      // An offline render would flood the log with one line per beat.
+      if (realtime)
+        rtLog.log(RtLogEvent::Click, step / stepsPerBeat, offset, accent ? 1 : 0);
+
+      lastClickSample = clickSample;
+      lastClickSampleValid = true;
+    }
+  }
+
+  renderClick(buffer, rendered, endSample - rendered);
+
+  // Lanes play over the same span, so loop wraps and tempo map changes split them too.
+  if (clickTables != nullptr)
+    polyrhythm.render(buffer, *clickTables, clock.beatPosition, clock.beatsPerSample, clock.beatsPerBar, startSample,
+                      endSample, processedSamples, getSoundVolume());
+}
+
+void VizBeatsAudioProcessor::recordDspLoad(juce::int64 startTicks, int numSamples) noexcept
+{
+  const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+  loadMeasurer.registerRenderTime(elapsedSeconds * 1000.0, numSamples);
+
+  const auto budgetSeconds = static_cast<double>(numSamples) / sampleRateHz;
+  if (budgetSeconds <= 0.0)
+    return;
+
+  // Only the audio thread raises the peak; the editor may reset it concurrently.
+  const auto load = elapsedSeconds / budgetSeconds;
+  if (load > peakDspLoad.load(std::memory_order_relaxed))
+    peakDspLoad.store(load, std::memory_order_relaxed);
+}
+
+bool VizBeatsAudioProcessor::computeBeatPhase(BeatClock& outClock, bool& outRunning, const BlockPosition& block,
+                                              double manualBpm, int beatsPerBar, bool internalPlay, int numSamples,
+                                              bool realtime)
+{
+  const ScopedTrace trace("computeBeatPhase");
   outRunning = false;
 
-  const auto info = getHostInfo();
+  const auto& info = block.host;
   const auto bpm = info.hasBpm ? info.bpm : manualBpm;
+  outClock.beatsPerBar = juce::jmax(1, beatsPerBar);
 
   if (info.isPlaying)
   {
@@ -436,59 +606,41 @@ bool VizBeatsAudioProcessor::computeBeatPhase(double& outPhase, bool& outRunning
     // Preferred: host PPQ position (phase locked to musical beats).
     if (info.hasPpqPosition)
     {
-      auto phase = info.ppqPosition - std::floor(info.ppqPosition);
-      if (phase < 0.0)
-        phase += 1.0;
-      outPhase = phase;
+      setPhaseSource(BeatPhaseSource::HostPpq);
+
+      // Clicks follow the meter's beats, which are only quarter notes in x/4.
+      outClock.beatPosition = info.bar.getBeatPosition();
+      outClock.beatsPerSample = bpm / (60.0 * sampleRateHz * info.bar.getQuartersPerBeat());
+      outClock.beatsPerBar = info.bar.numerator;
+
       hostFallbackRunning = false;
-      hostFallbackPhaseSamples = 0.0;
+      hostFallbackBeatPosition = 0.0;
       return true;
     }
 
     // Fallback: host time (seconds/samples) + BPM.
     // Some hosts don't provide PPQ but do provide time; some provide BPM only.
     const auto bpmForPhase = juce::jlimit(30.0, 300.0, bpm);
-    const auto secondsPerBeat = bpmForPhase > 0.0 ? (60.0 / bpmForPhase) : 0.0;
+    outClock.beatsPerSample = bpmForPhase / (60.0 * sampleRateHz);
 
-    if (secondsPerBeat > 0.0)
+    // Offline renders skip the seconds: the sample position is exact, seconds may be rounded.
+    if (realtime && block.hasTimeInSeconds)
     {
-      if (auto* playHead = getPlayHead())
-      {
-        if (auto position = playHead->getPosition())
-        {
-          if (auto timeSeconds = position->getTimeInSeconds())
-          {
-            const auto t = *timeSeconds;
-            if (std::isfinite(t))
-            {
-              auto wrapped = std::fmod(t, secondsPerBeat);
-              if (wrapped < 0.0)
-                wrapped += secondsPerBeat;
-              outPhase = wrapped / secondsPerBeat;
-              hostFallbackRunning = false;
-              hostFallbackPhaseSamples = 0.0;
-              return true;
-            }
-          }
-
-          if (auto timeSamples = position->getTimeInSamples())
-          {
-            const auto samples = static_cast<double>(*timeSamples);
-            if (std::isfinite(samples) && sampleRateHz > 0.0)
-            {
-              const auto t = samples / sampleRateHz;
-              auto wrapped = std::fmod(t, secondsPerBeat);
-              if (wrapped < 0.0)
-                wrapped += secondsPerBeat;
-              outPhase = wrapped / secondsPerBeat;
-              hostLastSamplePos = samples;
-              hostFallbackRunning = false;
-              hostFallbackPhaseSamples = 0.0;
-              return true;
-            }
-          }
-        }
-      }
+      outClock.beatPosition = block.timeInSeconds * bpmForPhase / 60.0;
+      hostFallbackRunning = false;
+      hostFallbackBeatPosition = 0.0;
+      setPhaseSource(BeatPhaseSource::HostSeconds);
+      return true;
+    }
+
+    if (block.hasTimeInSamples)
+    {
+      const auto samples = static_cast<double>(block.timeInSamples);
+      outClock.beatPosition = samples * outClock.beatsPerSample;
+      hostFallbackRunning = false;
+      hostFallbackBeatPosition = 0.0;
+      setPhaseSource(BeatPhaseSource::HostSamples);
+      return true;
     }
 
     // Last resort: advance an internal phase when host is playing but provides neither PPQ nor time.
@@ -496,116 +648,240 @@ bool VizBeatsAudioProcessor::computeBeatPhase(double& outPhase, bool& outRunning
     if (!hostFallbackRunning)
     {
       hostFallbackRunning = true;
-      hostFallbackPhaseSamples = 0.0;
+      hostFallbackBeatPosition = 0.0;
     }
 
-    hostSamplesPerBeat = sampleRateHz * (60.0 / bpmForPhase);
-    const auto phaseSamples = hostFallbackPhaseSamples;
-    hostFallbackPhaseSamples += static_cast<double>(numSamples);
-
-    const auto wrapped = hostSamplesPerBeat > 0.0 ? std::fmod(phaseSamples, hostSamplesPerBeat) : 0.0;
-    outPhase = hostSamplesPerBeat > 0.0 ? wrapped / hostSamplesPerBeat : 0.0;
+    setPhaseSource(BeatPhaseSource::HostFallback);
+    outClock.beatPosition = hostFallbackBeatPosition;
+    hostFallbackBeatPosition += static_cast<double>(numSamples) * outClock.beatsPerSample;
     return true;
   }
 
   hostFallbackRunning = false;
-  hostFallbackPhaseSamples = 0.0;
+  hostFallbackBeatPosition = 0.0;
 
   if (internalPlay)
   {
     outRunning = true;
-    internalSamplesPerBeat = sampleRateHz * (60.0 / juce::jlimit(30.0, 300.0, bpm));
 
-    if (internalSamplesPerBeat > 0.0)
+    if (activeTempoMap != nullptr)
     {
-      const auto wrappedSamples = std::fmod(internalPhaseSamples, internalSamplesPerBeat);
-      outPhase = wrappedSamples / internalSamplesPerBeat;
-    }
-    else
-    {
-      outPhase = 0.0;
+      setPhaseSource(BeatPhaseSource::TempoMap);
+      outClock = getTempoMapClock(tempoMapCursor.seek(static_cast<double>(tempoMapSample) / sampleRateHz), tempoMapSample);
+      return true;
     }
 
-    internalPhaseSamples += static_cast<double>(numSamples);
+    setPhaseSource(BeatPhaseSource::Internal);
+
+    outClock.beatPosition = internalBeatPosition;
+    outClock.beatsPerSample = juce::jlimit(30.0, 300.0, bpm) / (60.0 * sampleRateHz);
+
+    internalBeatPosition += static_cast<double>(numSamples) * outClock.beatsPerSample;
     return true;
   }
 
-  internalPhaseSamples = 0.0;
+  internalBeatPosition = 0.0;
+  tempoMapSample = 0;
+  setPhaseSource(BeatPhaseSource::None);
   return false;
 }
 
-void VizBeatsAudioProcessor::resetClick()
+VizBeatsAudioProcessor::BeatClock VizBeatsAudioProcessor::getTempoMapClock(const TempoMap::Segment& segment,
+                                                                           juce::int64 sample) const noexcept
 {
-  clickSamplesLeft = 0;
-  lastBeatPhaseValid = false;
-  lastRunning = false;
-  lastBarProgressValid = false;
-  lastBarProgress01 = 0.0;
-  lastBeatsPerBarForProgress = 0;
-  internalPhaseSamples = 0.0;
-  internalBeatCounter = 0;
-  lastInternalPlay = false;
-  lastSubdivPhaseValid = false;
-  lastSubdivPhase = 0.0;
+  const auto beat = segment.beatAtSeconds(static_cast<double>(sample) / sampleRateHz);
+  const auto bar = TempoMap::getBarPosition(segment, beat);
+
+  BeatClock clock;
+  clock.beatPosition = bar.getBeatPosition();
+  clock.beatsPerSample = segment.beatsPerSecond / (sampleRateHz * bar.getQuartersPerBeat());
+  clock.beatsPerBar = bar.numerator;
+  return clock;
 }
 
-void VizBeatsAudioProcessor::triggerClick(bool accent)
+void VizBeatsAudioProcessor::renderTempoMapClicks(juce::AudioBuffer<float>& buffer, int numSamples, bool realtime)
 {
-  clickSamplesLeft = clickLengthSamples;
-  clickPhase = 0.0;
-
-  if (accent)
+  // Split at every tempo or meter change inside the block. Each part's clock comes from its
+  // segment start, not from the previous block, so nothing accumulates over a long set.
+  int start = 0;
+  while (start < numSamples)
   {
-    clickGainCurrent = 0.60f;
-    clickFreqStartCurrent = 2800.0;
-    clickFreqEndCurrent = 1100.0;
+    const auto sample = tempoMapSample + start;
+    const auto& segment = tempoMapCursor.seek(static_cast<double>(sample) / sampleRateHz);
+
+    auto end = numSamples;
+    const auto nextSeconds = tempoMapCursor.getNextSegmentSeconds();
+    if (nextSeconds >= 0.0)
+    {
+      const auto nextSample = static_cast<juce::int64>(std::ceil(nextSeconds * sampleRateHz)) - tempoMapSample;
+      if (nextSample < numSamples)
+        end = juce::jmax(start + 1, static_cast<int>(nextSample));
+    }
+
+    renderBeatClicks(buffer, getTempoMapClock(segment, sample), start, end, realtime);
+    start = end;
   }
-  else
+}
+
+void VizBeatsAudioProcessor::setTempoMap(std::shared_ptr<const TempoMap> map)
+{
+  JUCE_ASSERT_MESSAGE_THREAD
+
+  tempoMap = map;
+  tempoMapBuffer.getWriteBuffer() = std::move(map);
+  tempoMapBuffer.publish();
+
+  // The slot handed back is one the audio thread no longer reads, so the map it held is
+  // released here rather than on the audio thread.
+  tempoMapBuffer.getWriteBuffer() = nullptr;
+}
+
+void VizBeatsAudioProcessor::setPolyrhythmLanes(const PolyrhythmLanes& lanes)
+{
+  JUCE_ASSERT_MESSAGE_THREAD
+
+  if (lanes == polyrhythmLanes)
+    return;
+
+  polyrhythmLanes = lanes;
+
+  auto stored = apvts.state.getChildWithName(PolyrhythmLanes::valueTreeType);
+  if (stored.isValid())
+    apvts.state.removeChild(stored, nullptr);
+
+  apvts.state.appendChild(polyrhythmLanes.toValueTree(), nullptr);
+  publishPolyrhythmLanes();
+}
+
+void VizBeatsAudioProcessor::publishPolyrhythmLanes() noexcept
+{
+  polyrhythmBuffer.getWriteBuffer() = polyrhythmLanes;
+  polyrhythmBuffer.publish();
+}
+
+bool VizBeatsAudioProcessor::detectDiscontinuity(const BlockPosition& block, const BeatClock& clock, bool realtime)
+{
+  // PPQ is compared in quarter notes: the meter's beat count restarts when the meter changes.
+  if (phaseSource == BeatPhaseSource::HostPpq)
   {
-    clickGainCurrent = clickGain;
-    clickFreqStartCurrent = clickFreqStart;
-    clickFreqEndCurrent = clickFreqEnd;
+    if (!expectedPpqValid)
+      return false;
+
+    const auto& info = block.host;
+    const auto error = info.ppqPosition - expectedPpq;
+    const bool jumped = std::abs(error) > kPpqJumpToleranceBeats;
+    if (realtime)
+      hostTiming.recordPpqError(error * 60.0 / info.bpm, jumped);
+
+    if (jumped)
+      rtLog.log(RtLogEvent::PpqJump, expectedPpq, info.ppqPosition);
+
+    return jumped;
   }
+
+  // The fallback and internal clocks advance themselves; only host time can jump.
+  if (!expectedBeatPositionValid
+      || (phaseSource != BeatPhaseSource::HostSeconds && phaseSource != BeatPhaseSource::HostSamples))
+    return false;
+
+  const bool jumped = std::abs(clock.beatPosition - expectedBeatPosition) > kPpqJumpToleranceBeats;
+  if (jumped)
+    rtLog.log(RtLogEvent::PositionJump, expectedBeatPosition, clock.beatPosition);
+
+  return jumped;
 }
 
-void VizBeatsAudioProcessor::triggerSubdivisionClick()
+bool VizBeatsAudioProcessor::findLoopWrap(const BlockPosition& block, const BeatClock& clock, int numSamples,
+                                          int& outSample, BeatClock& outClock) const
 {
-  // Softer, higher-pitched click for subdivisions
-  clickSamplesLeft = static_cast<int>(clickLengthSamples * 0.6); // Shorter click
-  clickPhase = 0.0;
-  clickGainCurrent = clickGain * 0.35f; // Much softer
-  clickFreqStartCurrent = 3200.0; // Higher pitch
-  clickFreqEndCurrent = 1800.0;
+  if (phaseSource != BeatPhaseSource::HostPpq || !block.isLooping || clock.beatsPerSample <= 0.0)
+    return false;
+
+  const auto& info = block.host;
+  const auto ppqPerSample = clock.beatsPerSample * info.bar.getQuartersPerBeat();
+  if (block.loopEndPpq - block.loopStartPpq <= ppqPerSample || info.ppqPosition >= block.loopEndPpq)
+    return false;
+
+  // Hosts that split the block at the loop end never get here: the next block starts at the
+  // loop start and is caught as a discontinuity instead.
+  const auto samplesToLoopEnd = (block.loopEndPpq - info.ppqPosition) / ppqPerSample;
+  if (samplesToLoopEnd < 0.5 || samplesToLoopEnd >= static_cast<double>(numSamples) - 0.5)
+    return false;
+
+  outSample = juce::roundToInt(samplesToLoopEnd);
+
+  // The host's bar start is for the current position, not the loop start. Its bar lines are
+  // carried back to the loop start in the current meter, so with a pickup bar the loop's
+  // downbeats still fall on the host's.
+  const auto quartersPerBeat = info.bar.getQuartersPerBeat();
+  const auto barLength = static_cast<double>(info.bar.numerator) * quartersPerBeat;
+  const auto barOffset = std::fmod(info.ppqPosition - info.bar.beatInBar * quartersPerBeat, barLength);
+  const auto loopBarStart = barOffset + std::floor((block.loopStartPpq - barOffset) / barLength) * barLength;
+
+  const auto loopBar = BarPosition::fromPpq(block.loopStartPpq,
+                                            juce::AudioPlayHead::TimeSignature { info.bar.numerator, info.bar.denominator },
+                                            loopBarStart, juce::nullopt, info.bar.numerator);
+
+  outClock.beatPosition = loopBar.getBeatPosition() + (static_cast<double>(outSample) - samplesToLoopEnd) * clock.beatsPerSample;
+  outClock.beatsPerSample = clock.beatsPerSample;
+  outClock.beatsPerBar = loopBar.numerator;
+  return true;
 }
 
-void VizBeatsAudioProcessor::renderClick(juce::AudioBuffer<float>& buffer)
+void VizBeatsAudioProcessor::setPhaseSource(BeatPhaseSource source) noexcept
 {
-  if (clickSamplesLeft <= 0 || sampleRateHz <= 0.0)
+  if (source == phaseSource)
     return;
 
-  const auto numSamples = buffer.getNumSamples();
-  const auto numCh = buffer.getNumChannels();
-  const auto volume = getSoundVolume();
+  phaseSource = source;
+  expectedPpqValid = false;
+  expectedBeatPositionValid = false;
+  rtLog.log(RtLogEvent::PhaseSource, 0.0, 0.0, static_cast<juce::int64>(source));
+}
 
-  for (int i = 0; i < numSamples; ++i)
-  {
-    if (clickSamplesLeft <= 0)
-      break;
+void VizBeatsAudioProcessor::resetClick()
+{
+  activeClick = nullptr;
+  polyrhythm.reset();
+  lastRunning = false;
+  internalBeatPosition = 0.0;
+  tempoMapSample = 0;
+  lastClickSampleValid = false;
+}
+
+void VizBeatsAudioProcessor::triggerClick(bool accent)
+{
+  if (clickTables != nullptr)
+    activeClick = &clickTables->get(accent ? ClickTables::Type::Accent : ClickTables::Type::Normal);
 
-    const auto t = 1.0 - static_cast<double>(clickSamplesLeft) / static_cast<double>(clickLengthSamples);
-    const auto freq = clickFreqStartCurrent + (clickFreqEndCurrent - clickFreqStartCurrent) * t;
-    clickPhaseDelta = juce::MathConstants<double>::twoPi * freq / sampleRateHz;
+  clickPosition = 0;
+}
 
-    const auto env = static_cast<float>(std::exp(-5.0 * t));
-    const auto tone = static_cast<float>(std::sin(clickPhase));
-    const auto sample = clickGainCurrent * volume * env * tone;
-    clickPhase += clickPhaseDelta;
+void VizBeatsAudioProcessor::triggerSubdivisionClick()
+{
+  if (clickTables != nullptr)
+    activeClick = &clickTables->get(ClickTables::Type::Subdivision);
 
-    for (int ch = 0; ch < numCh; ++ch)
-      buffer.addSample(ch, i, sample);
+  clickPosition = 0;
+}
 
-    --clickSamplesLeft;
-  }
+void VizBeatsAudioProcessor::renderClick(juce::AudioBuffer<float>& buffer, int startSample, int numSamplesToRender)
+{
+  if (activeClick == nullptr || numSamplesToRender <= 0)
+    return;
+
+  const ScopedTrace trace("renderClick");
+  const auto& click = *activeClick;
+  const auto numSamples = juce::jmin(numSamplesToRender, static_cast<int>(click.size()) - clickPosition);
+  const auto numCh = buffer.getNumChannels();
+  const auto volume = getSoundVolume();
+
+  for (int ch = 0; ch < numCh; ++ch)
+    buffer.addFrom(ch, startSample, click.data() + clickPosition, numSamples, volume);
+
+  clickPosition += numSamples;
+  if (clickPosition >= static_cast<int>(click.size()))
+    activeClick = nullptr;
 }
 
 bool VizBeatsAudioProcessor::hasEditor() const
@@ -627,8 +903,39 @@ void VizBeatsAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 void VizBeatsAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
   const auto state = juce::ValueTree::readFromData(data, static_cast<size_t>(sizeInBytes));
-  if (state.isValid())
-    apvts.replaceState(state);
+  if (!state.isValid())
+    return;
+
+  apvts.replaceState(state);
+
+  // Sessions saved before lanes existed have none. Lanes are only ever set on the message
+  // thread (single writer for the audio hand-off), and some hosts restore state elsewhere.
+  const auto lanes = PolyrhythmLanes::fromValueTree(apvts.state.getChildWithName(PolyrhythmLanes::valueTreeType));
+
+  if (juce::MessageManager::existsAndIsCurrentThread())
+  {
+    cancelPendingUpdate(); // an older off-thread restore must not win
+    setPolyrhythmLanes(lanes);
+    return;
+  }
+
+  {
+    const juce::SpinLock::ScopedLockType lock(restoredLanesLock);
+    restoredLanes = lanes;
+  }
+
+  triggerAsyncUpdate();
+}
+
+void VizBeatsAudioProcessor::handleAsyncUpdate()
+{
+  PolyrhythmLanes lanes;
+  {
+    const juce::SpinLock::ScopedLockType lock(restoredLanesLock);
+    lanes = restoredLanes;
+  }
+
+  setPolyrhythmLanes(lanes);
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
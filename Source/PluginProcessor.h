@@ -1,6 +1,16 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BarPosition.h"
+#include "ClickTables.h"
+#include "HostTimingProfiler.h"
+#include "PolyrhythmLanes.h"
+#include "RtLog.h"
+#include "TempoMap.h"
+#include "TripleBuffer.h"
+
+#include <memory>
+#include <vector>
 
 // Visual mode enumeration
 enum class VisualMode
@@ -22,7 +32,8 @@ enum class ColorTheme
   HighContrast
 };
 
-class VizBeatsAudioProcessor final : public juce::AudioProcessor
+class VizBeatsAudioProcessor final : public juce::AudioProcessor,
+                                     private juce::AsyncUpdater
 {
 public:
   VizBeatsAudioProcessor();
@@ -61,13 +72,65 @@ public:
     double bpm = 120.0;
     bool hasPpqPosition = false;
     double ppqPosition = 0.0;
+    BarPosition bar; // Only meaningful with hasPpqPosition.
+
+    bool operator==(const HostInfo& other) const noexcept
+    {
+      return isPlaying == other.isPlaying && hasBpm == other.hasBpm && bpm == other.bpm
+             && hasPpqPosition == other.hasPpqPosition && ppqPosition == other.ppqPosition && bar == other.bar;
+    }
+
+    bool operator!=(const HostInfo& other) const noexcept { return !operator==(other); }
   };
 
-  HostInfo getHostInfo() const noexcept;
-  void refreshHostInfo();
+  // The last realtime block as the audio thread played it. Published as one snapshot, so
+  // the editor never mixes a new beat with an old bar or an old discontinuity generation.
+  struct PlayInfo
+  {
+    HostInfo host;
+    bool isRunning = false; // clicking, from the host transport or internal play
+    double bpm = 120.0;     // quarter-note tempo the clicks play at; only while running
+    BarPosition bar;        // at the block's first sample, for every phase source; only while running
+
+    // Bumped whenever the position jumps (seek, loop). A bar index change without a new
+    // generation is a real bar wrap.
+    juce::uint32 discontinuityGeneration = 0;
+
+    bool operator==(const PlayInfo& other) const noexcept
+    {
+      return host == other.host && isRunning == other.isRunning && bpm == other.bpm && bar == other.bar
+             && discontinuityGeneration == other.discontinuityGeneration;
+    }
+
+    bool operator!=(const PlayInfo& other) const noexcept { return !operator==(other); }
+  };
+
+  // Message thread only (the single reader of the hand-off).
+  PlayInfo getPlayInfo() noexcept;
+
+  // What the host delivers to processBlock(); read and reset from the editor.
+  HostTimingProfiler& getHostTimingProfiler() noexcept { return hostTiming; }
+
+  // processBlock() time as a proportion of the block's real-time budget (1.0 = all of it):
+  // smoothed, and the worst single block since prepareToPlay() or resetPeakDspLoad().
+  double getDspLoad() const { return loadMeasurer.getLoadAsProportion(); }
+  double getPeakDspLoad() const noexcept { return peakDspLoad.load(std::memory_order_relaxed); }
+  void resetPeakDspLoad() noexcept { peakDspLoad.store(0.0, std::memory_order_relaxed); }
+
+  // Message thread. While set, internal play follows the map's tempo and meter changes
+  // (from its start) instead of Manual BPM; nullptr goes back to Manual BPM.
+  void setTempoMap(std::shared_ptr<const TempoMap> map);
+  std::shared_ptr<const TempoMap> getTempoMap() const { return tempoMap; }
+
+  // Message thread. Pulse lanes played against the bar with the main beat. Kept in the plugin
+  // state rather than as parameters: a lane set is one setting, not something to automate.
+  void setPolyrhythmLanes(const PolyrhythmLanes& lanes);
+  const PolyrhythmLanes& getPolyrhythmLanes() const noexcept { return polyrhythmLanes; }
 
   // Helper methods to get settings
   VisualMode getVisualMode() const;
+  double getManualBpm() const;
+  bool getInternalPlay() const;
   ColorTheme getColorTheme() const;
   int getBeatsPerBar() const;
   int getSubdivisions() const;
@@ -79,53 +142,124 @@ public:
   static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
 private:
-  void updateHostInfo();
+  // Everything processBlock() reads from the play head for one block.
+  struct BlockPosition
+  {
+    HostInfo host;
+    bool hasTimeInSeconds = false;
+    double timeInSeconds = 0.0;
+    bool hasTimeInSamples = false;
+    juce::int64 timeInSamples = 0;
+    bool isLooping = false;
+    double loopStartPpq = 0.0;
+    double loopEndPpq = 0.0;
+  };
+
+  // Beat position at the first sample of a block (or of the part after a loop wrap), and
+  // how far it moves per sample. Beats whose index is a multiple of beatsPerBar are accented.
+  struct BeatClock
+  {
+    double beatPosition = 0.0;
+    double beatsPerSample = 0.0;
+    int beatsPerBar = 4;
+  };
+
+  BlockPosition readBlockPosition(int numSamples, bool realtime, int beatsPerBar);
+  BarPosition getBlockBar(const BlockPosition& block, const BeatClock& clock) noexcept;
+  void publishPlayInfo(const HostInfo& host, bool isRunning, const BeatClock& clock, const BarPosition& bar) noexcept;
   void resetClick();
   void triggerClick(bool accent);
   void triggerSubdivisionClick();
-  void renderClick(juce::AudioBuffer<float>& buffer);
-  bool computeBeatPhase(double& outPhase, bool& outRunning, double manualBpm, bool internalPlay, int numSamples);
+  void renderClick(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+  void renderBeatClicks(juce::AudioBuffer<float>& buffer, const BeatClock& clock, int startSample, int endSample, bool realtime);
+  bool computeBeatPhase(BeatClock& outClock, bool& outRunning, const BlockPosition& block, double manualBpm,
+                        int beatsPerBar, bool internalPlay, int numSamples, bool realtime);
+  bool detectDiscontinuity(const BlockPosition& block, const BeatClock& clock, bool realtime);
+  BeatClock getTempoMapClock(const TempoMap::Segment& segment, juce::int64 sample) const noexcept;
+  void renderTempoMapClicks(juce::AudioBuffer<float>& buffer, int numSamples, bool realtime);
+  bool findLoopWrap(const BlockPosition& block, const BeatClock& clock, int numSamples, int& outSample, BeatClock& outClock) const;
+  void setPhaseSource(BeatPhaseSource source) noexcept;
+  void publishPolyrhythmLanes() noexcept;
+  void handleAsyncUpdate() override;
+  void recordDspLoad(juce::int64 startTicks, int numSamples) noexcept;
 
-  std::atomic<bool> hostIsPlaying { false };
-  std::atomic<bool> hostHasBpm { false };
-  std::atomic<double> hostBpm { 120.0 };
-  std::atomic<bool> hostHasPpqPosition { false };
-  std::atomic<double> hostPpqPosition { 0.0 };
+  std::atomic<float>* manualBpmParam = nullptr;
+  std::atomic<float>* internalPlayParam = nullptr;
+  std::atomic<float>* visualModeParam = nullptr;
+  std::atomic<float>* colorThemeParam = nullptr;
+  std::atomic<float>* beatsPerBarParam = nullptr;
+  std::atomic<float>* subdivisionsParam = nullptr;
+  std::atomic<float>* soundVolumeParam = nullptr;
+  std::atomic<float>* previewSubdivisionsParam = nullptr;
+
+  // Audio thread to editor, once per realtime block.
+  TripleBuffer<PlayInfo> playInfoBuffer;
 
   double sampleRateHz = 44100.0;
-  double internalPhaseSamples = 0.0;
-  double internalSamplesPerBeat = 44100.0;
-  double hostSamplesPerBeat = 0.0;
-  double hostLastSamplePos = 0.0;
+  // Counted in beats rather than samples, so a tempo change doesn't move the bar position.
+  double internalBeatPosition = 0.0;
   bool hostFallbackRunning = false;
-  double hostFallbackPhaseSamples = 0.0;
+  double hostFallbackBeatPosition = 0.0;
+
+  // Tempo map hand-off: the message thread publishes, the audio thread picks the latest up at
+  // the start of a block. Maps are only ever released on the message thread.
+  std::shared_ptr<const TempoMap> tempoMap;
+  TripleBuffer<std::shared_ptr<const TempoMap>> tempoMapBuffer;
+  const TempoMap* activeTempoMap = nullptr;
+  TempoMap::Cursor tempoMapCursor;
+  juce::int64 tempoMapSample = 0; // samples since internal play started
+
+  // Lane settings are handed over the same way. The audio thread's scheduler keeps its own
+  // copy, laid out for per-block scheduling.
+  PolyrhythmLanes polyrhythmLanes;
+  TripleBuffer<PolyrhythmLanes> polyrhythmBuffer;
+  PolyrhythmScheduler polyrhythm;
+
+  // Lanes from a state restore that arrived off the message thread, applied from there.
+  PolyrhythmLanes restoredLanes;
+  juce::SpinLock restoredLanesLock;
 
-	  double lastBeatPhase = 0.0;
-	  bool lastBeatPhaseValid = false;
 	  bool lastRunning = false;
-	  double lastBarProgress01 = 0.0;
-	  bool lastBarProgressValid = false;
-	  int lastBeatsPerBarForProgress = 0;
-
-  int clickSamplesLeft = 0;
-  int clickLengthSamples = 1764; // ~40 ms at 44.1k
-  float clickGain = 0.45f;
-  float clickGainCurrent = 0.45f;
-  double clickPhase = 0.0;
-  double clickPhaseDelta = 0.0;
-  double clickFreqStart = 2200.0;
-  double clickFreqEnd = 800.0;
-  double clickFreqStartCurrent = 2200.0;
-  double clickFreqEndCurrent = 800.0;
-  juce::Random rand;
+
+  // Click sounds are shared by every instance at the same sample rate; the audio thread
+  // only reads the table picked in prepareToPlay().
+  juce::SharedResourcePointer<ClickTableCache> clickTableCache;
+  std::shared_ptr<const ClickTables> clickTables;
+  const std::vector<float>* activeClick = nullptr;
+  int clickPosition = 0;
 
   double lastClickBpm = 120.0;
-  bool lastInternalPlay = false;
-  int64_t internalBeatCounter = 0;
 
-  // Subdivision tracking
-  double lastSubdivPhase = 0.0;
-  bool lastSubdivPhaseValid = false;
+  bool lastRealtime = true;
+
+  // Clicks are scheduled on the sample of each beat boundary. Samples are counted from
+  // prepareToPlay(), so a boundary rounded onto both sides of a block edge only clicks once.
+  juce::int64 processedSamples = 0;
+  juce::int64 lastClickSample = 0;
+  bool lastClickSampleValid = false;
+
+  // Clicks per beat in this block: 1, or the subdivisions while Preview Subdivisions is on.
+  int clickSubdivisions = 1;
+
+  // Always-on diagnostic event log. The audio thread only calls rtLog.log(), which never
+  // locks or allocates; events are logged on change, not per block.
+  RtLogChannel rtLog;
+  HostTimingProfiler hostTiming;
+
+  juce::AudioProcessLoadMeasurer loadMeasurer;
+  std::atomic<double> peakDspLoad { 0.0 };
+  BeatPhaseSource phaseSource = BeatPhaseSource::None;
+  int preparedBlockSize = 0;
+  int largestBlockSize = 0;
+  double lastLoggedBpm = 0.0;
+
+  // Where the previous block predicted this one starts (after any loop wrap it contained).
+  // A different position is a seek or an unannounced loop: the click schedule is re-seeded.
+  double expectedPpq = 0.0;
+  bool expectedPpqValid = false;
+  double expectedBeatPosition = 0.0;
+  bool expectedBeatPositionValid = false;
+  juce::uint32 discontinuityGeneration = 0;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VizBeatsAudioProcessor)
 };
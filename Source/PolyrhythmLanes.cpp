@@ -0,0 +1,227 @@
+#include "PolyrhythmLanes.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr auto kLaneType = "LANE";
+constexpr auto kPulsesProperty = "pulses";
+constexpr auto kAccentsProperty = "accents";
+constexpr auto kVoiceProperty = "voice";
+
+// Pulses off the lane's accent pattern play at this gain.
+constexpr float kUnaccentedGain = 0.55f;
+
+// As for the main beat: a pulse this soon after the last one is the same boundary seen again
+// from the next block.
+constexpr juce::int64 kDuplicatePulseSamples = 2;
+
+// Far enough back that no pulse is taken for a duplicate of it, and never overflows the
+// difference against a real sample count.
+constexpr juce::int64 kNoPulse = std::numeric_limits<juce::int64>::min() / 2;
+} // namespace
+
+//==============================================================================
+int PolyrhythmLanes::getNumActiveLanes() const noexcept
+{
+  int count = 0;
+  for (const auto& lane : lanes)
+    if (lane.isActive())
+      ++count;
+
+  return count;
+}
+
+PolyrhythmLanes PolyrhythmLanes::fromPulses(std::initializer_list<int> pulsesPerLane)
+{
+  PolyrhythmLanes result;
+  size_t index = 0;
+
+  for (const auto pulses : pulsesPerLane)
+  {
+    if (index >= result.lanes.size())
+      break;
+
+    auto& lane = result.lanes[index];
+    lane.pulses = juce::jlimit(0, maxPulses, pulses);
+    lane.accents = 1u;
+    lane.voice = static_cast<int>(index) % ClickTables::numLaneVoices;
+    ++index;
+  }
+
+  return result;
+}
+
+juce::ValueTree PolyrhythmLanes::toValueTree() const
+{
+  juce::ValueTree tree(valueTreeType);
+
+  for (const auto& lane : lanes)
+  {
+    if (!lane.isActive())
+      continue;
+
+    juce::ValueTree child(kLaneType);
+    child.setProperty(kPulsesProperty, lane.pulses, nullptr);
+    child.setProperty(kAccentsProperty, static_cast<juce::int64>(lane.accents), nullptr);
+    child.setProperty(kVoiceProperty, lane.voice, nullptr);
+    tree.appendChild(child, nullptr);
+  }
+
+  return tree;
+}
+
+PolyrhythmLanes PolyrhythmLanes::fromValueTree(const juce::ValueTree& tree)
+{
+  PolyrhythmLanes result;
+  if (!tree.hasType(valueTreeType))
+    return result;
+
+  size_t index = 0;
+  for (const auto& child : tree)
+  {
+    if (index >= result.lanes.size())
+      break;
+
+    const auto pulses = static_cast<int>(child.getProperty(kPulsesProperty, 0));
+    if (!child.hasType(kLaneType) || pulses <= 0 || pulses > maxPulses)
+      continue;
+
+    auto& lane = result.lanes[index++];
+    lane.pulses = pulses;
+    lane.accents = static_cast<juce::uint32>(static_cast<juce::int64>(child.getProperty(kAccentsProperty, 1)));
+    lane.voice = juce::jlimit(0, ClickTables::numLaneVoices - 1, static_cast<int>(child.getProperty(kVoiceProperty, 0)));
+  }
+
+  return result;
+}
+
+//==============================================================================
+void PolyrhythmScheduler::setLanes(const PolyrhythmLanes& lanes) noexcept
+{
+  pulsesPerBar.fill(0.0);
+  accents.fill(0u);
+  voices.fill(0);
+  numLanes = 0;
+
+  for (const auto& lane : lanes.lanes)
+  {
+    if (!lane.isActive())
+      continue;
+
+    const auto index = static_cast<size_t>(numLanes++);
+    pulsesPerBar[index] = static_cast<double>(juce::jmin(lane.pulses, PolyrhythmLanes::maxPulses));
+    accents[index] = lane.accents;
+    voices[index] = lane.voice;
+  }
+
+  // Lanes may have moved to other slots.
+  reset();
+}
+
+void PolyrhythmScheduler::reset() noexcept
+{
+  stopVoices();
+  forgetLastPulses();
+}
+
+void PolyrhythmScheduler::stopVoices() noexcept
+{
+  voiceData.fill(nullptr);
+  voicePosition.fill(0);
+}
+
+void PolyrhythmScheduler::forgetLastPulses() noexcept
+{
+  lastPulseSample.fill(kNoPulse);
+}
+
+void PolyrhythmScheduler::render(juce::AudioBuffer<float>& buffer, const ClickTables& tables, double beatPosition,
+                                 double beatsPerSample, int beatsPerBar, int startSample, int endSample,
+                                 juce::int64 blockStartSample, float volume) noexcept
+{
+  const auto numSamples = endSample - startSample;
+  if (numLanes == 0 || numSamples <= 0)
+    return;
+
+  // Every lane at once, without branches: its pulse position, speed and the boundaries that
+  // round onto a sample in the span. As for the main beat, boundaries in the last half sample
+  // belong to the next span. Inactive lanes have no pulses per bar, so their range is empty.
+  const auto barsPerBeat = 1.0 / static_cast<double>(juce::jmax(1, beatsPerBar));
+  const auto spanSamples = static_cast<double>(numSamples) - 0.5;
+  const auto speed = juce::jmax(0.0, beatsPerSample);
+
+  for (size_t i = 0; i < maxLanes; ++i)
+    pulsesPerSample[i] = speed * pulsesPerBar[i] * barsPerBeat;
+
+  for (size_t i = 0; i < maxLanes; ++i)
+    pulsePosition[i] = beatPosition * pulsesPerBar[i] * barsPerBeat;
+
+  for (size_t i = 0; i < maxLanes; ++i)
+    firstPulse[i] = std::ceil(pulsePosition[i] - 0.5 * pulsesPerSample[i]);
+
+  for (size_t i = 0; i < maxLanes; ++i)
+    pulseEnd[i] = pulsePosition[i] + pulsesPerSample[i] * spanSamples;
+
+  // Pulses themselves are rare: a few per lane per block at most.
+  for (size_t lane = 0; lane < static_cast<size_t>(numLanes); ++lane)
+  {
+    int rendered = startSample;
+
+    if (pulsesPerSample[lane] > 0.0)
+    {
+      const auto pulses = static_cast<juce::int64>(pulsesPerBar[lane]);
+
+      for (auto pulse = firstPulse[lane]; pulse < pulseEnd[lane]; pulse += 1.0)
+      {
+        const auto offset = juce::jlimit(rendered, endSample - 1,
+                                         startSample + static_cast<int>(std::round((pulse - pulsePosition[lane]) / pulsesPerSample[lane])));
+
+        const auto pulseSample = blockStartSample + offset;
+        if (pulseSample - lastPulseSample[lane] <= kDuplicatePulseSamples)
+          continue;
+
+        renderVoice(buffer, lane, rendered, offset - rendered, volume);
+        rendered = offset;
+
+        // Pulse index in the bar, also for positions before bar 0.
+        auto pulseInBar = static_cast<juce::int64>(pulse) % pulses;
+        if (pulseInBar < 0)
+          pulseInBar += pulses;
+
+        const auto accent = pulseInBar < PolyrhythmLanes::maxPulses && ((accents[lane] >> pulseInBar) & 1u) != 0;
+        triggerVoice(lane, tables, accent);
+        lastPulseSample[lane] = pulseSample;
+      }
+    }
+
+    renderVoice(buffer, lane, rendered, endSample - rendered, volume);
+  }
+}
+
+void PolyrhythmScheduler::triggerVoice(size_t lane, const ClickTables& tables, bool accent) noexcept
+{
+  const auto& click = tables.getLaneVoice(voices[lane]);
+  voiceData[lane] = click.data();
+  voiceLength[lane] = static_cast<int>(click.size());
+  voicePosition[lane] = 0;
+  voiceGain[lane] = accent ? 1.0f : kUnaccentedGain;
+}
+
+void PolyrhythmScheduler::renderVoice(juce::AudioBuffer<float>& buffer, size_t lane, int startSample, int numSamplesToRender,
+                                      float volume) noexcept
+{
+  if (voiceData[lane] == nullptr || numSamplesToRender <= 0)
+    return;
+
+  const auto numSamples = juce::jmin(numSamplesToRender, voiceLength[lane] - voicePosition[lane]);
+  const auto gain = volume * voiceGain[lane];
+
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    buffer.addFrom(ch, startSample, voiceData[lane] + voicePosition[lane], numSamples, gain);
+
+  voicePosition[lane] += numSamples;
+  if (voicePosition[lane] >= voiceLength[lane])
+    voiceData[lane] = nullptr;
+}
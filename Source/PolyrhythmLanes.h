@@ -0,0 +1,110 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ClickTables.h"
+
+#include <array>
+#include <initializer_list>
+
+// Pulse lanes played against the bar alongside the main beat. A lane with 3 pulses in a
+// 4-beat bar plays 3-against-4; one with 5 pulses in a 7-beat bar plays 5-against-7. Each
+// lane has its own accent pattern and click voice.
+//
+// A plain value: the editor edits it, the processor stores it in its state and hands a copy
+// to the audio thread, and frame states carry it to the traffic view.
+struct PolyrhythmLanes
+{
+  static constexpr int maxLanes = 8;
+  static constexpr int maxPulses = 32; // one accent bit per pulse
+
+  struct Lane
+  {
+    int pulses = 0;            // per bar; 0 = lane off
+    juce::uint32 accents = 1u; // bit i accents pulse i of the bar
+    int voice = 0;             // see ClickTables::getLaneVoice()
+
+    bool isActive() const noexcept { return pulses > 0; }
+    bool isAccented(int pulse) const noexcept { return pulse >= 0 && pulse < maxPulses && ((accents >> pulse) & 1u) != 0; }
+
+    bool operator==(const Lane& other) const noexcept
+    {
+      return pulses == other.pulses && accents == other.accents && voice == other.voice;
+    }
+
+    bool operator!=(const Lane& other) const noexcept { return !operator==(other); }
+  };
+
+  std::array<Lane, maxLanes> lanes {};
+
+  int getNumActiveLanes() const noexcept;
+
+  // One lane per entry, accented on the first pulse of the bar, voices taken in turn.
+  static PolyrhythmLanes fromPulses(std::initializer_list<int> pulsesPerLane);
+
+  // Stored as a child of the processor state; anything missing or out of range is dropped.
+  juce::ValueTree toValueTree() const;
+  static PolyrhythmLanes fromValueTree(const juce::ValueTree& tree);
+  static constexpr auto valueTreeType = "POLYRHYTHM";
+
+  bool operator==(const PolyrhythmLanes& other) const noexcept { return lanes == other.lanes; }
+  bool operator!=(const PolyrhythmLanes& other) const noexcept { return !operator==(other); }
+};
+
+// Schedules and plays every lane on the audio thread, over the same spans as the main beat.
+//
+// Lane state is kept as one array per field (structure of arrays), so finding where each
+// lane's pulses fall in a span is a few fixed-length loops over all lanes that the compiler
+// can vectorise. Only lanes that actually pulse or ring out in the span take the scalar path.
+class PolyrhythmScheduler
+{
+public:
+  PolyrhythmScheduler() noexcept { reset(); }
+
+  // Audio thread. Active lanes are packed first; voices still ringing are cut.
+  void setLanes(const PolyrhythmLanes& lanes) noexcept;
+
+  // Silences every lane and forgets the last pulses.
+  void reset() noexcept;
+  void stopVoices() noexcept;
+
+  // After a seek or loop: a pulse right at the new position plays instead of being taken
+  // for the one just before the jump.
+  void forgetLastPulses() noexcept;
+
+  // Adds the lanes' clicks in [startSample, endSample). beatPosition is in meter beats at
+  // startSample, with bar lines every beatsPerBar beats; blockStartSample is the running
+  // sample count at buffer index 0, used to drop a pulse seen again from the next block.
+  void render(juce::AudioBuffer<float>& buffer, const ClickTables& tables, double beatPosition, double beatsPerSample,
+              int beatsPerBar, int startSample, int endSample, juce::int64 blockStartSample, float volume) noexcept;
+
+private:
+  static constexpr size_t maxLanes = static_cast<size_t>(PolyrhythmLanes::maxLanes);
+
+  template <typename T>
+  using LaneArray = std::array<T, maxLanes>;
+
+  void triggerVoice(size_t lane, const ClickTables& tables, bool accent) noexcept;
+  void renderVoice(juce::AudioBuffer<float>& buffer, size_t lane, int startSample, int numSamples, float volume) noexcept;
+
+  int numLanes = 0;
+
+  // Settings, with inactive lanes at zero pulses so they fall out of the span loops.
+  LaneArray<double> pulsesPerBar {};
+  LaneArray<juce::uint32> accents {};
+  LaneArray<int> voices {};
+
+  // Per span: pulse position at the span start, pulses per sample, and the pulse boundaries
+  // [firstPulse, pulseEnd) that round onto a sample in the span.
+  LaneArray<double> pulsePosition {};
+  LaneArray<double> pulsesPerSample {};
+  LaneArray<double> firstPulse {};
+  LaneArray<double> pulseEnd {};
+
+  // One click voice per lane, so coinciding pulses from different lanes all sound.
+  LaneArray<const float*> voiceData {};
+  LaneArray<int> voiceLength {};
+  LaneArray<int> voicePosition {};
+  LaneArray<float> voiceGain {};
+
+  LaneArray<juce::int64> lastPulseSample {};
+};
@@ -0,0 +1,124 @@
+#include "QualityGovernor.h"
+
+namespace
+{
+// Decisions are made on the average of this many painted frames (~0.5 s at 60 Hz).
+constexpr int kWindowFrames = 30;
+
+// Stepping back up needs windows comfortably under budget.
+constexpr double kRecoveryHeadroom = 0.5;
+constexpr int kMinRecoveryWindows = 4;
+constexpr int kMaxRecoveryWindows = 64;
+
+// Degrading this soon after a recovery counts as a bounce and doubles the next hold time.
+constexpr int kBounceWindows = 8;
+} // namespace
+
+const char* QualityGovernor::getLevelName(Level level) noexcept
+{
+  switch (level)
+  {
+    case Level::Full: return "full";
+    case Level::ReducedResolution: return "reduced resolution";
+    case Level::NoGlow: return "no glow";
+    case Level::FewerRipples: return "fewer ripples";
+    case Level::ReducedFrameRate: return "reduced frame rate";
+    case Level::numLevels:
+    default: break;
+  }
+
+  return "full";
+}
+
+QualitySettings QualityGovernor::getSettings(Level level) noexcept
+{
+  const auto index = static_cast<int>(level);
+
+  QualitySettings settings;
+  if (index >= static_cast<int>(Level::ReducedResolution))
+    settings.resolutionScale = 0.5f;
+  if (index >= static_cast<int>(Level::NoGlow))
+    settings.softGlow = false;
+  if (index >= static_cast<int>(Level::FewerRipples))
+    settings.maxRipples = 2;
+  if (index >= static_cast<int>(Level::ReducedFrameRate))
+    settings.maxFrameRateHz = 30.0;
+
+  return settings;
+}
+
+QualityGovernor::QualityGovernor(double paintBudgetSeconds)
+    : budgetSeconds(paintBudgetSeconds), recoveryWindowsRequired(kMinRecoveryWindows)
+{
+}
+
+void QualityGovernor::recordPaintTime(double seconds) noexcept
+{
+  pendingMicros.fetch_add(static_cast<juce::int64>(seconds * 1.0e6), std::memory_order_relaxed);
+  pendingCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool QualityGovernor::update() noexcept
+{
+  const auto count = pendingCount.exchange(0, std::memory_order_relaxed);
+  const auto micros = pendingMicros.exchange(0, std::memory_order_relaxed);
+
+  windowMicros += micros;
+  windowCount += count;
+
+  if (windowCount < kWindowFrames)
+    return false;
+
+  lastWindowAverageSeconds = static_cast<double>(windowMicros) * 1.0e-6 / static_cast<double>(windowCount);
+  windowMicros = 0;
+  windowCount = 0;
+  windowsSinceRecovery = juce::jmin(windowsSinceRecovery + 1, kMaxRecoveryWindows * 2);
+
+  const auto current = level.load(std::memory_order_relaxed);
+  const auto lowest = static_cast<int>(Level::numLevels) - 1;
+
+  if (lastWindowAverageSeconds > budgetSeconds)
+  {
+    healthyWindows = 0;
+    if (current >= lowest)
+      return false;
+
+    if (windowsSinceRecovery <= kBounceWindows)
+      recoveryWindowsRequired = juce::jmin(kMaxRecoveryWindows, recoveryWindowsRequired * 2);
+
+    level.store(current + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  if (lastWindowAverageSeconds >= budgetSeconds * kRecoveryHeadroom || current == 0)
+  {
+    healthyWindows = 0;
+
+    // Long stretches at full quality forget earlier bounces.
+    if (current == 0 && windowsSinceRecovery > kMaxRecoveryWindows)
+      recoveryWindowsRequired = kMinRecoveryWindows;
+
+    return false;
+  }
+
+  if (++healthyWindows < recoveryWindowsRequired)
+    return false;
+
+  healthyWindows = 0;
+  windowsSinceRecovery = 0;
+  level.store(current - 1, std::memory_order_relaxed);
+  return true;
+}
+
+void QualityGovernor::reset() noexcept
+{
+  pendingMicros.store(0);
+  pendingCount.store(0);
+  level.store(0);
+  windowMicros = 0;
+  windowCount = 0;
+  lastWindowAverageSeconds = 0.0;
+  healthyWindows = 0;
+  recoveryWindowsRequired = kMinRecoveryWindows;
+  windowsSinceRecovery = 0;
+}
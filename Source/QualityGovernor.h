@@ -0,0 +1,68 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+
+// What a visualizer should draw at the current quality level.
+struct QualitySettings
+{
+  float resolutionScale = 1.0f; // Fraction of the physical resolution rendered, then upscaled.
+  bool softGlow = true;         // Halos, tail streak and the flash wash.
+  int maxRipples = 16;          // Newest ripples drawn per frame.
+  double maxFrameRateHz = 0.0;  // 0 = every vblank.
+};
+
+// Watches visualizer paint time against a per-editor budget and steps quality down when it
+// is exceeded, back up when there is headroom again.
+//
+// Levels degrade cumulatively in this order: lower internal resolution, no soft glow, fewer
+// ripples, lower frame rate. Paint times can be recorded from any thread (the render thread
+// paints too); update() runs on the message thread once per frame and makes the decisions.
+// Recovery needs a sustained margin below the budget, and the hold time doubles whenever a
+// recovered level immediately proves too slow again, so it doesn't oscillate.
+class QualityGovernor
+{
+public:
+  enum class Level
+  {
+    Full = 0,
+    ReducedResolution,
+    NoGlow,
+    FewerRipples,
+    ReducedFrameRate,
+    numLevels
+  };
+
+  static const char* getLevelName(Level level) noexcept;
+  static QualitySettings getSettings(Level level) noexcept;
+
+  explicit QualityGovernor(double paintBudgetSeconds = 0.004);
+
+  // Any thread.
+  void recordPaintTime(double seconds) noexcept;
+
+  // Message thread, once per frame. Returns true if the level changed.
+  bool update() noexcept;
+
+  Level getLevel() const noexcept { return static_cast<Level>(level.load(std::memory_order_relaxed)); }
+  QualitySettings getSettings() const noexcept { return getSettings(getLevel()); }
+  double getAveragePaintSeconds() const noexcept { return lastWindowAverageSeconds; }
+
+  void reset() noexcept;
+
+private:
+  const double budgetSeconds;
+
+  std::atomic<juce::int64> pendingMicros { 0 };
+  std::atomic<int> pendingCount { 0 };
+  std::atomic<int> level { 0 };
+
+  // Message thread only.
+  juce::int64 windowMicros = 0;
+  int windowCount = 0;
+  double lastWindowAverageSeconds = 0.0;
+  int healthyWindows = 0;
+  int recoveryWindowsRequired = 0;
+  int windowsSinceRecovery = 0;
+};
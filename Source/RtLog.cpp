@@ -0,0 +1,257 @@
+#include "RtLog.h"
+
+#include "Diagnostics.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr int kDrainIntervalMs = 100;
+
+// Rotate at this size, keeping this many older files (rt-log-<host>.1.txt, .2.txt, ...).
+constexpr juce::int64 kMaxLogBytes = 2 * 1024 * 1024;
+constexpr int kNumRotatedLogs = 2;
+
+const char* getEventName(RtLogEvent event) noexcept
+{
+  switch (event)
+  {
+    case RtLogEvent::Prepare: return "prepare";
+    case RtLogEvent::Release: return "release";
+    case RtLogEvent::TransportStart: return "transport_start";
+    case RtLogEvent::TransportStop: return "transport_stop";
+    case RtLogEvent::TempoChange: return "tempo_change";
+    case RtLogEvent::PhaseSource: return "phase_source";
+    case RtLogEvent::PpqJump: return "ppq_jump";
+    case RtLogEvent::OversizeBlock: return "oversize_block";
+    case RtLogEvent::Click: return "click";
+    case RtLogEvent::RenderMode: return "render_mode";
+    case RtLogEvent::PositionJump: return "position_jump";
+    case RtLogEvent::LoopWrap: return "loop_wrap";
+    case RtLogEvent::numEvents: break;
+  }
+
+  return "unknown";
+}
+
+juce::String formatPpq(double ppq)
+{
+  return std::isfinite(ppq) ? juce::String(ppq, 4) : juce::String("n/a");
+}
+
+juce::File getRotatedFile(const juce::File& logFile, int index)
+{
+  return logFile.getSiblingFile(logFile.getFileNameWithoutExtension() + "." + juce::String(index) + logFile.getFileExtension());
+}
+} // namespace
+
+const char* getBeatPhaseSourceName(BeatPhaseSource source) noexcept
+{
+  switch (source)
+  {
+    case BeatPhaseSource::None: return "none";
+    case BeatPhaseSource::HostPpq: return "host_ppq";
+    case BeatPhaseSource::HostSeconds: return "host_seconds";
+    case BeatPhaseSource::HostSamples: return "host_samples";
+    case BeatPhaseSource::HostFallback: return "host_fallback";
+    case BeatPhaseSource::Internal: return "internal";
+    case BeatPhaseSource::TempoMap: return "tempo_map";
+    case BeatPhaseSource::numSources: break;
+  }
+
+  return "unknown";
+}
+
+//==============================================================================
+RtLogWriter::RtLogWriter()
+    : juce::Thread("VizBeats log writer"),
+      startTicks(juce::Time::getHighResolutionTicks())
+{
+  // One file per host so two hosts running side by side don't write over each other.
+  auto hostName = juce::File::getSpecialLocation(juce::File::hostApplicationPath).getFileNameWithoutExtension();
+  hostName = juce::File::createLegalFileName(hostName.isNotEmpty() ? hostName : juce::String("unknown"));
+  logFile = getDiagnosticsDirectory().getChildFile("rt-log-" + hostName + ".txt");
+
+  startThread(juce::Thread::Priority::low);
+}
+
+RtLogWriter::~RtLogWriter()
+{
+  stopThread(2000);
+
+  // Channels unregister before the last pointer goes; flush whatever they left behind.
+  drainAll();
+}
+
+juce::uint32 RtLogWriter::addChannel(RtLogChannel& channel)
+{
+  const juce::ScopedLock sl(channelLock);
+  channels.addIfNotAlreadyThere(&channel);
+  return nextInstanceId++;
+}
+
+void RtLogWriter::removeChannel(RtLogChannel& channel)
+{
+  const juce::ScopedLock sl(channelLock);
+
+  // Final drain so events logged just before the instance went away are kept.
+  const auto dropped = channel.drain([this](const RtLogRecord& record) { writeRecord(record); });
+  if (dropped > 0 && stream != nullptr)
+    *stream << "#" << static_cast<int>(channel.getInstanceId()) << " dropped " << static_cast<int>(dropped) << " records\n";
+
+  channels.removeFirstMatchingValue(&channel);
+
+  if (stream != nullptr)
+    stream->flush();
+}
+
+void RtLogWriter::run()
+{
+  while (!threadShouldExit())
+  {
+    wait(kDrainIntervalMs);
+    drainAll();
+  }
+}
+
+void RtLogWriter::drainAll()
+{
+  const juce::ScopedLock sl(channelLock);
+
+  bool wroteAnything = false;
+
+  for (auto* channel : channels)
+  {
+    const auto dropped = channel->drain([this, &wroteAnything](const RtLogRecord& record)
+                                        {
+                                          writeRecord(record);
+                                          wroteAnything = true;
+                                        });
+
+    if (dropped > 0 && stream != nullptr)
+    {
+      *stream << "#" << static_cast<int>(channel->getInstanceId()) << " dropped " << static_cast<int>(dropped) << " records\n";
+      wroteAnything = true;
+    }
+  }
+
+  if (wroteAnything && stream != nullptr)
+  {
+    stream->flush();
+    rotateIfNeeded();
+  }
+}
+
+void RtLogWriter::writeRecord(const RtLogRecord& record)
+{
+  if (stream == nullptr)
+    openLog();
+
+  if (stream == nullptr)
+    return;
+
+  const auto seconds = juce::Time::highResolutionTicksToSeconds(record.ticks - startTicks);
+
+  juce::String line;
+  line << juce::String(seconds, 6).paddedLeft(' ', 12) << " #" << static_cast<int>(record.instanceId) << ' '
+       << getEventName(record.event);
+
+  switch (record.event)
+  {
+    case RtLogEvent::Prepare:
+      line << " sample_rate=" << record.a << " block_size=" << record.value;
+      break;
+    case RtLogEvent::TransportStart:
+      line << " bpm=" << juce::String(record.a, 3) << " ppq=" << formatPpq(record.b)
+           << " source=" << getBeatPhaseSourceName(static_cast<BeatPhaseSource>(record.value));
+      break;
+    case RtLogEvent::TempoChange:
+      line << " from=" << juce::String(record.a, 3) << " to=" << juce::String(record.b, 3);
+      break;
+    case RtLogEvent::PhaseSource:
+      line << " source=" << getBeatPhaseSourceName(static_cast<BeatPhaseSource>(record.value));
+      break;
+    case RtLogEvent::PpqJump:
+      line << " expected=" << formatPpq(record.a) << " reported=" << formatPpq(record.b);
+      break;
+    case RtLogEvent::OversizeBlock:
+      line << " prepared=" << static_cast<int>(record.a) << " received=" << record.value;
+      break;
+    case RtLogEvent::Click:
+      line << " beat=" << juce::String(record.a, record.a == std::floor(record.a) ? 0 : 2) << " offset=" << static_cast<int>(record.b)
+           << (record.value != 0 ? " accent" : "");
+      break;
+    case RtLogEvent::RenderMode:
+      line << (record.value != 0 ? " offline" : " realtime");
+      break;
+    case RtLogEvent::PositionJump:
+      line << " expected=" << juce::String(record.a, 4) << " reported=" << juce::String(record.b, 4);
+      break;
+    case RtLogEvent::LoopWrap:
+      line << " end=" << formatPpq(record.a) << " start=" << formatPpq(record.b) << " offset=" << record.value;
+      break;
+    case RtLogEvent::Release:
+    case RtLogEvent::TransportStop:
+    case RtLogEvent::numEvents:
+      break;
+  }
+
+  *stream << line << '\n';
+}
+
+void RtLogWriter::openLog()
+{
+  logFile.getParentDirectory().createDirectory();
+
+  auto newStream = std::make_unique<juce::FileOutputStream>(logFile);
+  if (!newStream->openedOk())
+    return;
+
+  stream = std::move(newStream);
+  *stream << "---- VizBeats log opened " << juce::Time::getCurrentTime().toISO8601(true) << " ----\n";
+}
+
+void RtLogWriter::rotateIfNeeded()
+{
+  if (stream == nullptr || stream->getPosition() < kMaxLogBytes)
+    return;
+
+  stream.reset();
+
+  getRotatedFile(logFile, kNumRotatedLogs).deleteFile();
+  for (int i = kNumRotatedLogs - 1; i >= 1; --i)
+    getRotatedFile(logFile, i).moveFileTo(getRotatedFile(logFile, i + 1));
+  logFile.moveFileTo(getRotatedFile(logFile, 1));
+
+  openLog();
+}
+
+//==============================================================================
+RtLogChannel::RtLogChannel()
+{
+  instanceId = writer->addChannel(*this);
+}
+
+RtLogChannel::~RtLogChannel()
+{
+  writer->removeChannel(*this);
+}
+
+void RtLogChannel::log(RtLogEvent event, double a, double b, juce::int64 value) noexcept
+{
+  const auto scope = fifo.write(1);
+
+  if (scope.blockSize1 + scope.blockSize2 == 0)
+  {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  auto& record = records[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+  record.ticks = juce::Time::getHighResolutionTicks();
+  record.instanceId = instanceId;
+  record.event = event;
+  record.a = a;
+  record.b = b;
+  record.value = value;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+
+// Where computeBeatPhase() took the beat phase from for a block.
+enum class BeatPhaseSource
+{
+  None = 0,     // Stopped.
+  HostPpq,      // Host PPQ position.
+  HostSeconds,  // Host time in seconds + BPM.
+  HostSamples,  // Host time in samples + BPM.
+  HostFallback, // Host playing without position: internal sample counter at host/manual BPM.
+  Internal,     // Internal preview play.
+  TempoMap,     // Internal play following an imported tempo map.
+  numSources
+};
+
+const char* getBeatPhaseSourceName(BeatPhaseSource source) noexcept;
+
+// Events recorded from the audio thread. The meaning of a/b/value is per event.
+enum class RtLogEvent : juce::uint16
+{
+  Prepare = 0,     // a = sample rate, value = max block size
+  Release,
+  TransportStart,  // a = bpm, b = ppq (NaN without PPQ), value = BeatPhaseSource
+  TransportStop,
+  TempoChange,     // a = old bpm, b = new bpm
+  PhaseSource,     // value = new BeatPhaseSource
+  PpqJump,         // a = expected ppq, b = reported ppq
+  OversizeBlock,   // a = prepared max block size, value = block size received
+  Click,           // a = beat position (fractional between beats), b = sample offset, value = 1 for an accent
+  RenderMode,      // value = 1 when the host switched to non-realtime (offline) rendering
+  PositionJump,    // a = expected beat position, b = reported (host time without PPQ)
+  LoopWrap,        // a = loop end ppq, b = loop start ppq, value = sample offset in the block
+  numEvents
+};
+
+// One fixed-size binary record; formatting to text happens on the writer thread.
+struct RtLogRecord
+{
+  juce::int64 ticks = 0; // juce::Time::getHighResolutionTicks()
+  juce::uint32 instanceId = 0;
+  RtLogEvent event = RtLogEvent::Prepare;
+  juce::uint16 reserved = 0;
+  double a = 0.0;
+  double b = 0.0;
+  juce::int64 value = 0;
+};
+
+class RtLogChannel;
+
+// Process-wide background thread that drains every channel into a rotating text log in the
+// diagnostics directory (one file per host application, a few rotated predecessors kept).
+class RtLogWriter final : private juce::Thread
+{
+public:
+  RtLogWriter();
+  ~RtLogWriter() override;
+
+  juce::File getLogFile() const { return logFile; }
+
+private:
+  friend class RtLogChannel;
+
+  juce::uint32 addChannel(RtLogChannel& channel);
+  void removeChannel(RtLogChannel& channel);
+
+  void run() override;
+  void drainAll();
+  void writeRecord(const RtLogRecord& record);
+  void openLog();
+  void rotateIfNeeded();
+
+  juce::CriticalSection channelLock;
+  juce::Array<RtLogChannel*> channels;
+  juce::uint32 nextInstanceId = 1;
+
+  juce::File logFile;
+  std::unique_ptr<juce::FileOutputStream> stream;
+  juce::int64 startTicks = 0;
+
+  JUCE_DECLARE_NON_COPYABLE(RtLogWriter)
+};
+
+// Per-instance log queue: the audio thread writes records into a single-producer ring, the
+// shared writer thread drains it. log() never locks, allocates or blocks; when the ring is
+// full the record is dropped and counted.
+class RtLogChannel
+{
+public:
+  RtLogChannel();
+  ~RtLogChannel();
+
+  void log(RtLogEvent event, double a = 0.0, double b = 0.0, juce::int64 value = 0) noexcept;
+
+  juce::uint32 getInstanceId() const noexcept { return instanceId; }
+
+private:
+  friend class RtLogWriter;
+
+  static constexpr int capacity = 256; // Events are sparse; the writer drains every 100 ms.
+
+  // Writer thread only. Calls write(record) for every pending record; returns the number
+  // dropped since the last drain.
+  template <typename WriteFn>
+  juce::uint32 drain(WriteFn&& write)
+  {
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+      write(records[static_cast<size_t>(scope.startIndex1 + i)]);
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+      write(records[static_cast<size_t>(scope.startIndex2 + i)]);
+
+    return dropped.exchange(0, std::memory_order_relaxed);
+  }
+
+  juce::SharedResourcePointer<RtLogWriter> writer;
+  juce::uint32 instanceId = 0;
+
+  juce::AbstractFifo fifo { capacity };
+  std::array<RtLogRecord, capacity> records;
+  std::atomic<juce::uint32> dropped { 0 };
+
+  JUCE_DECLARE_NON_COPYABLE(RtLogChannel)
+};
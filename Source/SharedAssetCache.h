@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Process-wide cache of immutable assets (click tables, sprite atlases, glyph masks, ...).
+//
+// Hold one through a juce::SharedResourcePointer so every plugin instance in the process sees
+// the same cache, and keep the std::shared_ptr it hands out for as long as the asset is in
+// use. Entries are weak: an asset is freed once no instance uses it and rebuilt on the next
+// request. Lookups lock and may build, so make them when a key changes, never per frame or
+// per audio block.
+template <typename Key, typename Asset>
+class SharedAssetCache
+{
+public:
+  // Returns the asset for `key`, calling create() (which returns a std::shared_ptr<Asset>)
+  // if no live instance exists yet.
+  template <typename CreateFn>
+  std::shared_ptr<const Asset> get(const Key& key, CreateFn&& create)
+  {
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+      if (auto asset = it->second.lock())
+      {
+        if (it->first == key)
+          return asset;
+
+        ++it;
+      }
+      else
+      {
+        it = entries.erase(it);
+      }
+    }
+
+    std::shared_ptr<const Asset> asset = create();
+    entries.emplace_back(key, asset);
+    return asset;
+  }
+
+  // Number of assets currently alive (diagnostics and benchmarks).
+  size_t getNumLiveAssets() const
+  {
+    const juce::ScopedLock sl(lock);
+
+    size_t live = 0;
+    for (const auto& entry : entries)
+      live += entry.second.expired() ? 0 : 1;
+
+    return live;
+  }
+
+private:
+  juce::CriticalSection lock;
+  std::vector<std::pair<Key, std::weak_ptr<const Asset>>> entries;
+};
@@ -0,0 +1,187 @@
+#include "SpriteAtlas.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr float kOrbSize = 16.0f;
+
+// The tail sprite is drawn at this reference length/height and stretched per frame; the
+// streak is a trapezoid with a linear gradient, so scaling it is exact.
+constexpr float kTailRefLength = 128.0f;
+constexpr float kTailRefHeight = 8.8f;
+constexpr float kTailPlumeHalfFactor = 0.52f * 1.45f;
+}
+
+int OrbSpriteAtlas::glowToLevel(float glowAmt) noexcept
+{
+  const auto level = static_cast<int>(std::round(juce::jlimit(0.0f, maxGlow, glowAmt) / maxGlow * static_cast<float>(numGlowLevels - 1)));
+  return juce::jlimit(0, numGlowLevels - 1, level);
+}
+
+float OrbSpriteAtlas::levelToGlow(int level) noexcept
+{
+  return maxGlow * static_cast<float>(level) / static_cast<float>(numGlowLevels - 1);
+}
+
+OrbSpriteAtlas::Sprite OrbSpriteAtlas::renderSprite(float logicalSize, const std::function<void(juce::Graphics&, juce::Point<float>)>& draw) const
+{
+  Sprite sprite;
+  sprite.logicalSize = logicalSize;
+
+  const auto px = juce::jmax(1, static_cast<int>(std::ceil(logicalSize * scale)));
+  sprite.image = juce::Image(juce::Image::ARGB, px, px, true, juce::SoftwareImageType());
+
+  juce::Graphics g(sprite.image);
+  g.addTransform(juce::AffineTransform::scale(scale));
+  draw(g, { logicalSize * 0.5f, logicalSize * 0.5f });
+  return sprite;
+}
+
+OrbSpriteAtlas::Key OrbSpriteAtlas::makeKey(const ThemeColors& theme, float physicalScale) noexcept
+{
+  return { theme.accent.getARGB(), theme.accentSecondary.getARGB(), juce::jlimit(0.5f, 4.0f, physicalScale) };
+}
+
+bool OrbSpriteAtlas::prepare(const ThemeColors& theme, float physicalScale)
+{
+  const auto newScale = juce::jlimit(0.5f, 4.0f, physicalScale);
+  if (getKey() == makeKey(theme, physicalScale))
+    return false;
+
+  accentArgb = theme.accent.getARGB();
+  accentSecondaryArgb = theme.accentSecondary.getARGB();
+  scale = newScale;
+
+  const auto accent = theme.accent;
+
+  for (int level = 0; level < numGlowLevels; ++level)
+  {
+    const auto glowAmt = levelToGlow(level);
+
+    const float halo = 34.0f + 26.0f * glowAmt;
+    halos[static_cast<size_t>(level)] = renderSprite(halo + 2.0f, [accent, glowAmt, halo](juce::Graphics& g, juce::Point<float> c)
+    {
+      juce::ColourGradient haloG(accent.withAlpha(0.22f * glowAmt), c.x, c.y, accent.withAlpha(0.0f), c.x + halo * 0.5f, c.y, true);
+      g.setGradientFill(haloG);
+      g.fillEllipse(c.x - halo * 0.5f, c.y - halo * 0.5f, halo, halo);
+    });
+
+    orbs[static_cast<size_t>(level)] = renderSprite(kOrbSize + 4.0f, [accent, glowAmt](juce::Graphics& g, juce::Point<float> c)
+    {
+      g.setColour(juce::Colours::white.withAlpha(0.97f));
+      g.fillEllipse(c.x - kOrbSize * 0.5f, c.y - kOrbSize * 0.5f, kOrbSize, kOrbSize);
+
+      // Tiny accent edge to tie into theme.
+      g.setColour(accent.withAlpha(0.20f + 0.25f * glowAmt));
+      g.drawEllipse(c.x - kOrbSize * 0.5f, c.y - kOrbSize * 0.5f, kOrbSize, kOrbSize, 1.2f);
+    });
+  }
+
+  // Ripple rings at full strength; the fade-out is applied as blit opacity.
+  for (int step = 0; step < numRippleSteps; ++step)
+  {
+    const float t = static_cast<float>(step) / static_cast<float>(numRippleSteps - 1);
+    const float radius = 4.0f + t * rippleSpeed * rippleLifeSeconds;
+    const float stroke = 4.4f - 1.4f * t;
+    const float size = 2.0f * (radius * 1.12f + stroke) + 2.0f;
+
+    ripples[static_cast<size_t>(step)] = renderSprite(size, [accent, radius, stroke](juce::Graphics& g, juce::Point<float> c)
+    {
+      // Outer ring (more prominent)
+      g.setColour(accent.withAlpha(0.52f));
+      g.drawEllipse(c.x - radius, c.y - radius, radius * 2.0f, radius * 2.0f, stroke);
+
+      // Inner highlight
+      g.setColour(juce::Colours::white.withAlpha(0.18f));
+      g.drawEllipse(c.x - radius * 0.82f, c.y - radius * 0.82f, radius * 1.64f, radius * 1.64f, stroke * 0.62f);
+
+      // Soft halo
+      g.setColour(accent.withAlpha(0.20f));
+      g.drawEllipse(c.x - radius * 1.12f, c.y - radius * 1.12f, radius * 2.24f, radius * 2.24f, stroke * 0.55f);
+    });
+  }
+
+  // Tail: plume, streak and core at full strength, start on the left, orb end on the right.
+  {
+    const float halfEnd = kTailRefHeight * 0.52f;
+    const float halfStart = kTailRefHeight * 0.22f;
+    const float plumeHalf = kTailRefHeight * kTailPlumeHalfFactor;
+
+    const auto w = juce::jmax(1, static_cast<int>(std::ceil(kTailRefLength * scale)));
+    const auto h = juce::jmax(1, static_cast<int>(std::ceil(plumeHalf * 2.0f * scale)));
+    tail = juce::Image(juce::Image::ARGB, w, h, true, juce::SoftwareImageType());
+
+    juce::Graphics g(tail);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    const float startX = 0.0f;
+    const float endX = kTailRefLength;
+    const float y = plumeHalf;
+    const auto tailCol = accent.darker(0.45f);
+
+    const auto fillTrapezoid = [&g, startX, endX, y](float hStart, float hEnd, juce::Colour col)
+    {
+      juce::Path p;
+      p.startNewSubPath(startX, y - hStart);
+      p.lineTo(endX, y - hEnd);
+      p.lineTo(endX, y + hEnd);
+      p.lineTo(startX, y + hStart);
+      p.closeSubPath();
+
+      g.setGradientFill(juce::ColourGradient(col, endX, y, col.withAlpha(0.0f), startX, y, false));
+      g.fillPath(p);
+    };
+
+    // Soft outer plume, streak, then the bright core.
+    fillTrapezoid(halfStart * 1.35f, halfEnd * 1.45f, tailCol.withAlpha(0.18f));
+    fillTrapezoid(halfStart, halfEnd, tailCol.withAlpha(0.30f));
+    fillTrapezoid(halfStart * 0.28f, halfEnd * 0.32f, theme.accentSecondary.withAlpha(0.18f));
+  }
+
+  return true;
+}
+
+void OrbSpriteAtlas::drawSprite(juce::Graphics& g, const Sprite& sprite, juce::Point<float> centre, float opacity) const
+{
+  if (sprite.image.isNull() || opacity <= 0.0f || scale <= 0.0f)
+    return;
+
+  // Snap to the physical pixel grid so the blit stays an untransformed copy.
+  const auto half = sprite.logicalSize * 0.5f;
+  const auto x = std::round((centre.x - half) * scale) / scale;
+  const auto y = std::round((centre.y - half) * scale) / scale;
+
+  g.setOpacity(juce::jmin(1.0f, opacity));
+  g.drawImageTransformed(sprite.image, juce::AffineTransform::scale(1.0f / scale).translated(x, y));
+}
+
+void OrbSpriteAtlas::drawTail(juce::Graphics& g, float startX, float endX, float centreY, float height, float opacity) const
+{
+  if (tail.isNull() || endX <= startX || opacity <= 0.0f || scale <= 0.0f)
+    return;
+
+  const auto sx = (endX - startX) / kTailRefLength;
+  const auto sy = height / kTailRefHeight;
+  const auto drawnHalfHeight = kTailRefHeight * kTailPlumeHalfFactor * sy;
+
+  g.setOpacity(juce::jmin(1.0f, opacity));
+  g.drawImageTransformed(tail, juce::AffineTransform::scale(sx / scale, sy / scale).translated(startX, centreY - drawnHalfHeight));
+}
+
+void OrbSpriteAtlas::drawHalo(juce::Graphics& g, juce::Point<float> centre, float glowAmt) const
+{
+  drawSprite(g, halos[static_cast<size_t>(glowToLevel(glowAmt))], centre, 1.0f);
+}
+
+void OrbSpriteAtlas::drawOrb(juce::Graphics& g, juce::Point<float> centre, float glowAmt) const
+{
+  drawSprite(g, orbs[static_cast<size_t>(glowToLevel(glowAmt))], centre, 1.0f);
+}
+
+void OrbSpriteAtlas::drawRipple(juce::Graphics& g, juce::Point<float> centre, float age01) const
+{
+  const auto t = juce::jlimit(0.0f, 1.0f, age01);
+  const auto step = juce::jlimit(0, numRippleSteps - 1, static_cast<int>(std::round(t * static_cast<float>(numRippleSteps - 1))));
+  drawSprite(g, ripples[static_cast<size_t>(step)], centre, 1.0f - t);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedAssetCache.h"
+#include "Theme.h"
+
+#include <array>
+
+// Pre-rendered orb, halo, tail and ripple sprites for the traffic visualizer.
+//
+// Sprites are rasterised once per theme and physical pixel scale (glow and ripple age are
+// quantised into a fixed number of steps), so a frame only blits images with an opacity
+// instead of building paths and gradients. A prepared atlas is immutable, so one per
+// theme/scale is shared by every visualizer in the process (see OrbSpriteAtlasCache).
+class OrbSpriteAtlas
+{
+public:
+  // What a prepared atlas depends on.
+  struct Key
+  {
+    juce::uint32 accentArgb = 0;
+    juce::uint32 accentSecondaryArgb = 0;
+    float scale = 0.0f;
+
+    bool operator==(const Key& other) const noexcept
+    {
+      return accentArgb == other.accentArgb && accentSecondaryArgb == other.accentSecondaryArgb && scale == other.scale;
+    }
+
+    bool operator!=(const Key& other) const noexcept { return !operator==(other); }
+  };
+
+  static constexpr int numGlowLevels = 16;
+  static constexpr int numRippleSteps = 16;
+  static constexpr float maxGlow = 1.2f;
+
+  static constexpr float rippleLifeSeconds = 0.28f;
+  static constexpr float rippleSpeed = 120.0f; // px/sec
+
+  static Key makeKey(const ThemeColors& theme, float physicalScale) noexcept;
+  Key getKey() const noexcept { return { accentArgb, accentSecondaryArgb, scale }; }
+
+  // Rebuilds the sprites if the theme colours or scale changed; returns true if it did.
+  bool prepare(const ThemeColors& theme, float physicalScale);
+
+  // startX/endX span the streak; height is the streak height the paths used to take.
+  void drawTail(juce::Graphics& g, float startX, float endX, float centreY, float height, float opacity) const;
+  void drawHalo(juce::Graphics& g, juce::Point<float> centre, float glowAmt) const;
+  void drawOrb(juce::Graphics& g, juce::Point<float> centre, float glowAmt) const;
+  void drawRipple(juce::Graphics& g, juce::Point<float> centre, float age01) const;
+
+private:
+  struct Sprite
+  {
+    juce::Image image;
+    float logicalSize = 0.0f;
+  };
+
+  static int glowToLevel(float glowAmt) noexcept;
+  static float levelToGlow(int level) noexcept;
+
+  Sprite renderSprite(float logicalSize, const std::function<void(juce::Graphics&, juce::Point<float>)>& draw) const;
+  void drawSprite(juce::Graphics& g, const Sprite& sprite, juce::Point<float> centre, float opacity) const;
+
+  juce::uint32 accentArgb = 0;
+  juce::uint32 accentSecondaryArgb = 0;
+  float scale = 0.0f;
+
+  std::array<Sprite, numGlowLevels> halos;
+  std::array<Sprite, numGlowLevels> orbs;
+  std::array<Sprite, numRippleSteps> ripples;
+  juce::Image tail;
+};
+
+using OrbSpriteAtlasCache = SharedAssetCache<OrbSpriteAtlas::Key, OrbSpriteAtlas>;
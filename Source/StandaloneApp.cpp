@@ -5,7 +5,8 @@
 
 namespace
 {
-class MainWindow final : public juce::DocumentWindow
+class MainWindow final : public juce::DocumentWindow,
+                         private juce::MenuBarModel
 {
 public:
   explicit MainWindow(VizBeatsAudioProcessor& processor)
@@ -20,20 +21,78 @@ public:
     player.setProcessor(&audioProcessor);
     deviceManager.addAudioCallback(&player);
 
+    setMenuBar(this);
     setContentOwned(audioProcessor.createEditor(), true);
     centreWithSize(getWidth(), getHeight());
     setVisible(true);
   }
 
+  ~MainWindow() override
+  {
+    setMenuBar(nullptr);
+  }
+
   void closeButtonPressed() override
   {
     juce::JUCEApplication::getInstance()->systemRequestedQuit();
   }
 
 private:
+  enum MenuItem
+  {
+    loadTempoMapItem = 1,
+    clearTempoMapItem
+  };
+
+  juce::StringArray getMenuBarNames() override { return { "Tempo Map" }; }
+
+  juce::PopupMenu getMenuForIndex(int, const juce::String&) override
+  {
+    juce::PopupMenu menu;
+    menu.addItem(loadTempoMapItem, "Load MIDI Tempo Map...");
+    menu.addItem(clearTempoMapItem, "Clear Tempo Map", audioProcessor.getTempoMap() != nullptr);
+    return menu;
+  }
+
+  void menuItemSelected(int itemId, int) override
+  {
+    if (itemId == loadTempoMapItem)
+      chooseTempoMap();
+    else if (itemId == clearTempoMapItem)
+      setTempoMap(nullptr, {});
+  }
+
+  void chooseTempoMap()
+  {
+    fileChooser = std::make_unique<juce::FileChooser>("Load a tempo map", juce::File(), "*.mid;*.midi");
+    fileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                             [this](const juce::FileChooser& chooser)
+                             {
+                               const auto file = chooser.getResult();
+                               if (file == juce::File())
+                                 return;
+
+                               juce::String error;
+                               if (auto map = TempoMap::loadMidiFile(file, error))
+                                 setTempoMap(std::move(map), file.getFileName());
+                               else
+                                 juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                                                        "Tempo map not loaded", error);
+                             });
+  }
+
+  // Internal play follows the map from its start; the title shows which one is loaded.
+  void setTempoMap(std::shared_ptr<const TempoMap> map, const juce::String& name)
+  {
+    audioProcessor.setTempoMap(std::move(map));
+    setName(name.isEmpty() ? juce::String("VizBeats") : "VizBeats - " + name);
+    menuItemsChanged();
+  }
+
   VizBeatsAudioProcessor& audioProcessor;
   juce::AudioDeviceManager deviceManager;
   juce::AudioProcessorPlayer player;
+  std::unique_ptr<juce::FileChooser> fileChooser;
 };
 } // namespace
 
@@ -0,0 +1,166 @@
+#include "TempoMap.h"
+
+#include <algorithm>
+
+namespace
+{
+constexpr double kDefaultBpm = 120.0;
+constexpr double kMinBpm = 1.0;
+constexpr double kMaxBpm = 999.0;
+constexpr int kMaxNumerator = 64;
+} // namespace
+
+TempoMap::TempoMap(std::vector<Change> changes)
+{
+  std::stable_sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) { return a.beat < b.beat; });
+
+  Segment current;
+  current.beatsPerSecond = kDefaultBpm / 60.0;
+  segments.push_back(current);
+
+  for (const auto& change : changes)
+  {
+    const auto beat = juce::jmax(0.0, change.beat);
+    auto& last = segments.back();
+
+    Segment next = last;
+    next.startBeat = beat;
+    next.startSeconds = last.secondsAtBeat(beat);
+
+    if (change.bpm > 0.0)
+      next.beatsPerSecond = juce::jlimit(kMinBpm, kMaxBpm, change.bpm) / 60.0;
+
+    if (change.numerator > 0 && change.numerator <= kMaxNumerator && change.denominator > 0
+        && juce::isPowerOfTwo(change.denominator))
+    {
+      // The new meter starts a bar here, after however many bars the old one completed.
+      const auto barLength = last.numerator * 4.0 / last.denominator;
+      const auto barsSoFar = std::ceil((beat - last.meterStartBeat) / barLength - 1.0e-9);
+
+      next.numerator = change.numerator;
+      next.denominator = change.denominator;
+      next.meterStartBeat = beat;
+      next.meterStartBar = last.meterStartBar + static_cast<juce::int64>(juce::jmax(0.0, barsSoFar));
+    }
+
+    // Several changes at the same beat (tempo and meter events are separate in MIDI) merge
+    // into one segment.
+    if (beat <= last.startBeat)
+    {
+      next.startSeconds = last.startSeconds;
+      last = next;
+    }
+    else
+    {
+      segments.push_back(next);
+    }
+  }
+}
+
+std::shared_ptr<const TempoMap> TempoMap::loadMidiFile(const juce::File& file, juce::String& error)
+{
+  juce::FileInputStream stream(file);
+  if (!stream.openedOk())
+  {
+    error = "Couldn't open " + file.getFileName();
+    return nullptr;
+  }
+
+  juce::MidiFile midiFile;
+  if (!midiFile.readFrom(stream))
+  {
+    error = file.getFileName() + " is not a readable MIDI file";
+    return nullptr;
+  }
+
+  // Negative time formats are SMPTE frames, which carry no musical beats.
+  const auto ticksPerQuarter = static_cast<double>(midiFile.getTimeFormat());
+  if (ticksPerQuarter <= 0.0)
+  {
+    error = file.getFileName() + " uses SMPTE timing, which has no beats to follow";
+    return nullptr;
+  }
+
+  juce::MidiMessageSequence tempoEvents;
+  juce::MidiMessageSequence timeSigEvents;
+  midiFile.findAllTempoEvents(tempoEvents);
+  midiFile.findAllTimeSigEvents(timeSigEvents);
+
+  std::vector<Change> changes;
+  changes.reserve(static_cast<size_t>(tempoEvents.getNumEvents() + timeSigEvents.getNumEvents()));
+
+  for (const auto* event : tempoEvents)
+  {
+    const auto secondsPerQuarter = event->message.getTempoSecondsPerQuarterNote();
+    if (secondsPerQuarter > 0.0)
+      changes.push_back({ event->message.getTimeStamp() / ticksPerQuarter, 60.0 / secondsPerQuarter, 0, 0 });
+  }
+
+  for (const auto* event : timeSigEvents)
+  {
+    int numerator = 0;
+    int denominator = 0;
+    event->message.getTimeSignatureInfo(numerator, denominator);
+    changes.push_back({ event->message.getTimeStamp() / ticksPerQuarter, 0.0, numerator, denominator });
+  }
+
+  if (changes.empty())
+  {
+    error = file.getFileName() + " has no tempo or time signature events";
+    return nullptr;
+  }
+
+  return std::make_shared<const TempoMap>(std::move(changes));
+}
+
+size_t TempoMap::findSegmentIndexAtSeconds(double seconds) const noexcept
+{
+  const auto next = std::upper_bound(segments.begin(), segments.end(), seconds,
+                                     [](double s, const Segment& segment) { return s < segment.startSeconds; });
+  return next == segments.begin() ? 0 : static_cast<size_t>(next - segments.begin()) - 1;
+}
+
+const TempoMap::Segment& TempoMap::getSegmentAtSeconds(double seconds) const noexcept
+{
+  return segments[findSegmentIndexAtSeconds(seconds)];
+}
+
+const TempoMap::Segment& TempoMap::getSegmentAtBeat(double beat) const noexcept
+{
+  const auto next = std::upper_bound(segments.begin(), segments.end(), beat,
+                                     [](double b, const Segment& segment) { return b < segment.startBeat; });
+  return next == segments.begin() ? segments.front() : *(next - 1);
+}
+
+BarPosition TempoMap::getBarPosition(const Segment& segment, double beat) noexcept
+{
+  const auto barLength = segment.numerator * 4.0 / segment.denominator;
+  const auto bars = std::floor((beat - segment.meterStartBeat) / barLength);
+
+  return BarPosition::fromPpq(beat, juce::AudioPlayHead::TimeSignature { segment.numerator, segment.denominator },
+                              segment.meterStartBeat + bars * barLength,
+                              segment.meterStartBar + static_cast<juce::int64>(bars), segment.numerator);
+}
+
+//==============================================================================
+const TempoMap::Segment& TempoMap::Cursor::seek(double seconds) noexcept
+{
+  jassert(map != nullptr);
+  const auto& segments = map->segments;
+
+  if (index >= segments.size() || seconds < segments[index].startSeconds)
+  {
+    index = map->findSegmentIndexAtSeconds(seconds);
+    return segments[index];
+  }
+
+  while (index + 1 < segments.size() && segments[index + 1].startSeconds <= seconds)
+    ++index;
+
+  return segments[index];
+}
+
+double TempoMap::Cursor::getNextSegmentSeconds() const noexcept
+{
+  return map != nullptr && index + 1 < map->segments.size() ? map->segments[index + 1].startSeconds : -1.0;
+}
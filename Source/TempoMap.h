@@ -0,0 +1,91 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "BarPosition.h"
+
+#include <memory>
+#include <vector>
+
+// A tempo and meter map (e.g. imported from a Standard MIDI File) for click tracks with
+// tempo changes.
+//
+// Stored as segments sorted by start, each with its cumulative start in seconds and beats
+// (quarter notes), so a position is always computed from the nearest segment start rather
+// than accumulated block by block: it stays exact over hour-long sets. Offsets are kept in
+// seconds rather than samples, so one map serves every sample rate.
+//
+// Immutable once built; share it as std::shared_ptr<const TempoMap>.
+class TempoMap
+{
+public:
+  // A tempo and/or meter change at a beat. Zero fields keep the previous value.
+  struct Change
+  {
+    double beat = 0.0;
+    double bpm = 0.0;
+    int numerator = 0;
+    int denominator = 0;
+  };
+
+  struct Segment
+  {
+    double startBeat = 0.0;
+    double startSeconds = 0.0;
+    double beatsPerSecond = 2.0;
+
+    // The meter, and where its bar count starts (meter changes start a new bar).
+    int numerator = 4;
+    int denominator = 4;
+    double meterStartBeat = 0.0;
+    juce::int64 meterStartBar = 0;
+
+    double getBpm() const noexcept { return beatsPerSecond * 60.0; }
+    double beatAtSeconds(double seconds) const noexcept { return startBeat + (seconds - startSeconds) * beatsPerSecond; }
+    double secondsAtBeat(double beat) const noexcept { return startSeconds + (beat - startBeat) / beatsPerSecond; }
+  };
+
+  // Changes may be in any order; the first segment always starts at beat 0 (120 BPM, 4/4
+  // unless a change at beat 0 says otherwise).
+  explicit TempoMap(std::vector<Change> changes);
+
+  // Tempo and time signature meta events from every track. Returns nullptr and sets `error`
+  // if the file can't be read or has no usable events.
+  static std::shared_ptr<const TempoMap> loadMidiFile(const juce::File& file, juce::String& error);
+
+  // O(log n) lookups. Positions before the start use the first segment.
+  const Segment& getSegmentAtSeconds(double seconds) const noexcept;
+  const Segment& getSegmentAtBeat(double beat) const noexcept;
+  double secondsToBeat(double seconds) const noexcept { return getSegmentAtSeconds(seconds).beatAtSeconds(seconds); }
+  double beatToSeconds(double beat) const noexcept { return getSegmentAtBeat(beat).secondsAtBeat(beat); }
+
+  static BarPosition getBarPosition(const Segment& segment, double beat) noexcept;
+  BarPosition getBarPosition(double beat) const noexcept { return getBarPosition(getSegmentAtBeat(beat), beat); }
+
+  const std::vector<Segment>& getSegments() const noexcept { return segments; }
+
+  // Streaming lookup for playback: moving forward (or staying put) is amortised O(1), and only
+  // a step back falls back to a binary search. Real-time safe.
+  class Cursor
+  {
+  public:
+    void reset(const TempoMap* newMap) noexcept
+    {
+      map = newMap;
+      index = 0;
+    }
+
+    const Segment& seek(double seconds) noexcept;
+
+    // Start of the segment after the current one, or a negative value for the last one.
+    double getNextSegmentSeconds() const noexcept;
+
+  private:
+    const TempoMap* map = nullptr;
+    size_t index = 0;
+  };
+
+private:
+  size_t findSegmentIndexAtSeconds(double seconds) const noexcept;
+
+  std::vector<Segment> segments;
+};
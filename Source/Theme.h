@@ -0,0 +1,66 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Color themes
+struct ThemeColors
+{
+  juce::Colour background;
+  juce::Colour accent;
+  juce::Colour accentSecondary;
+  juce::Colour textPrimary;
+  juce::Colour textMuted;
+  juce::Colour panelBg;
+  juce::Colour barMarker;
+};
+
+// Palettes are immutable, so they are built once and handed out by reference.
+inline const ThemeColors& getThemeColors(ColorTheme theme)
+{
+  static const ThemeColors themes[] = {
+    // CalmBlue
+    {
+      juce::Colour(0xff0b1323), // background
+      juce::Colour(0xff32b7ff), // accent
+      juce::Colour(0xff2da5ff), // accentSecondary
+      juce::Colour(0xffffffff), // textPrimary
+      juce::Colour(0xff9aa8bd), // textMuted
+      juce::Colour(0xff1e2b3e), // panelBg
+      juce::Colour(0xff32b7ff)  // barMarker
+    },
+    // WarmSunset
+    {
+      juce::Colour(0xff1a1210), // background
+      juce::Colour(0xffff9a3c), // accent (orange)
+      juce::Colour(0xffff7b2e), // accentSecondary
+      juce::Colour(0xffffffff), // textPrimary
+      juce::Colour(0xffbda99a), // textMuted
+      juce::Colour(0xff2e201e), // panelBg
+      juce::Colour(0xffff9a3c)  // barMarker
+    },
+    // ForestMint
+    {
+      juce::Colour(0xff0b1a14), // background
+      juce::Colour(0xff3cffaa), // accent (mint)
+      juce::Colour(0xff2ee89a), // accentSecondary
+      juce::Colour(0xffffffff), // textPrimary
+      juce::Colour(0xff9abda8), // textMuted
+      juce::Colour(0xff1e2e28), // panelBg
+      juce::Colour(0xff3cffaa)  // barMarker
+    },
+    // HighContrast
+    {
+      juce::Colour(0xff000000), // background (pure black)
+      juce::Colour(0xffffffff), // accent (white)
+      juce::Colour(0xffcccccc), // accentSecondary
+      juce::Colour(0xffffffff), // textPrimary
+      juce::Colour(0xff888888), // textMuted
+      juce::Colour(0xff1a1a1a), // panelBg
+      juce::Colour(0xffffffff)  // barMarker (white)
+    }
+  };
+
+  const auto index = juce::jlimit(0, static_cast<int>(std::size(themes)) - 1, static_cast<int>(theme));
+  return themes[index];
+}
@@ -0,0 +1,150 @@
+#include "ThreadedTrafficView.h"
+#include "TraceRecorder.h"
+
+#include <cmath>
+
+ThreadedTrafficView::ThreadedTrafficView()
+    : juce::Thread("VizBeats render")
+{
+  setOpaque(true);
+  startThread(juce::Thread::Priority::high);
+}
+
+ThreadedTrafficView::~ThreadedTrafficView()
+{
+  signalThreadShouldExit();
+  notify();
+  stopThread(1000);
+}
+
+void ThreadedTrafficView::submit(const BeatFrameState& state, const ThemeColors& colors, juce::uint32 themeGeneration, bool force)
+{
+  const bool changed = !hasSubmitted
+                       || lastSubmitted.width != getWidth() || lastSubmitted.height != getHeight()
+                       || lastSubmitted.scale != lastPaintScale
+                       || lastSubmitted.themeGeneration != themeGeneration
+                       || lastSubmitted.frame.beatsPerBar != state.beatsPerBar
+                       || lastSubmitted.frame.subdivisions != state.subdivisions
+                       || lastSubmitted.frame.lanes != state.lanes
+                       || lastSubmitted.frame.running != state.running;
+
+  if (!force && !changed)
+    return;
+
+  backgroundColour = colors.background;
+
+  auto& job = jobs.getWriteBuffer();
+  job.frame = state;
+  job.theme = colors;
+  job.themeGeneration = themeGeneration;
+  job.width = getWidth();
+  job.height = getHeight();
+  job.scale = lastPaintScale;
+
+  lastSubmitted = job;
+  hasSubmitted = true;
+  jobs.publish();
+
+  notify();
+}
+
+void ThreadedTrafficView::run()
+{
+  // A raster that couldn't be written yet; paint() frees its image within one blit.
+  constexpr int retryMilliseconds = 1;
+  bool rasterPending = false;
+
+  while (!threadShouldExit())
+  {
+    wait(rasterPending ? retryMilliseconds : 100);
+
+    if (threadShouldExit())
+      break;
+
+    // The read slot stays ours until the next update(), so a pending job can be retried.
+    if (jobs.update())
+    {
+      applyJob(jobs.getReadBuffer());
+      rasterPending = true;
+    }
+
+    if (rasterPending)
+      rasterPending = !rasterise(jobs.getReadBuffer());
+  }
+}
+
+void ThreadedTrafficView::applyJob(const Job& job)
+{
+  // Animation state advances once per job, however many tries its raster takes.
+  visualizer.setColors(job.theme, job.themeGeneration);
+  visualizer.applyFrameState(job.frame);
+  animating.store(visualizer.isAnimating(), std::memory_order_relaxed);
+}
+
+bool ThreadedTrafficView::rasterise(const Job& job)
+{
+  const ScopedTrace trace("ThreadedTrafficView::render");
+
+  if (job.width <= 0 || job.height <= 0)
+    return true;
+
+  const auto published = publishedIndex.load();
+  const auto target = published == 0 ? 1 : 0;
+
+  // Pairs with paint(): it stores readingIndex and then re-checks publishedIndex, so either
+  // it sees the new index or this sees it still reading the old one.
+  if (readingIndex.load() == target)
+    return false;
+
+  const auto scale = juce::jlimit(0.5f, 4.0f, job.scale);
+  const auto w = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(job.width) * scale)));
+  const auto h = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(job.height) * scale)));
+
+  auto& image = images[static_cast<size_t>(target)];
+  if (image.getWidth() != w || image.getHeight() != h)
+    image = juce::Image(juce::Image::RGB, w, h, false, juce::SoftwareImageType());
+
+  // Offscreen and invisible, so bounds changes here never touch the message thread.
+  visualizer.setBounds(0, 0, job.width, job.height);
+
+  {
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    visualizer.paint(g);
+  }
+
+  publishedIndex.store(target);
+  completedFrames.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+void ThreadedTrafficView::paint(juce::Graphics& g)
+{
+  const ScopedTrace trace("ThreadedTrafficView::paint");
+  lastPaintScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+  // Claim the published image; if the render thread published another one in between,
+  // retry so it never writes into the image being blitted.
+  int index = publishedIndex.load();
+  for (;;)
+  {
+    if (index < 0)
+      break;
+
+    readingIndex.store(index);
+    const auto recheck = publishedIndex.load();
+    if (recheck == index)
+      break;
+
+    index = recheck;
+  }
+
+  if (index < 0)
+  {
+    g.fillAll(backgroundColour);
+    return;
+  }
+
+  g.drawImage(images[static_cast<size_t>(index)], getLocalBounds().toFloat());
+  readingIndex.store(-1);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Theme.h"
+#include "TripleBuffer.h"
+#include "Visualizers.h"
+
+#include <array>
+#include <atomic>
+
+// Traffic visualizer rendered off the message thread.
+//
+// The message thread submits each frame's inputs; a dedicated render thread applies them to
+// a private, offscreen TrafficVisualizer and rasterises it with the software renderer into
+// one of two images. paint() only blits the most recently completed image.
+//
+// Hand-off is lock-free in both directions: frame inputs travel through a TripleBuffer, and
+// the image pair is coordinated with two atomics (the published index and the index the
+// message thread is currently blitting). The render thread never writes into the image being
+// read; if it would have to, it keeps the raster pending and retries shortly after, so the last
+// frame submitted (such as the one that settles the view after a stop) is always drawn.
+class ThreadedTrafficView final : public juce::Component, private juce::Thread
+{
+public:
+  ThreadedTrafficView();
+  ~ThreadedTrafficView() override;
+
+  // Message thread: queue a frame for rendering. Unless forced, the frame is only queued if
+  // something visible (size, theme, meter, running state) differs from the last one queued.
+  void submit(const BeatFrameState& state, const ThemeColors& colors, juce::uint32 themeGeneration, bool force);
+
+  // Increments whenever the render thread completes a frame; repaint when it changes.
+  juce::uint32 getCompletedFrameSerial() const noexcept { return completedFrames.load(std::memory_order_acquire); }
+
+  // True while flash/ripple animations of the last rendered frame are still decaying.
+  bool isAnimating() const noexcept { return animating.load(std::memory_order_relaxed); }
+
+  void setProfiler(FrameProfiler* p) { visualizer.setProfiler(p); }
+  void setQualityGovernor(QualityGovernor* g) { visualizer.setQualityGovernor(g); }
+
+  void paint(juce::Graphics& g) override;
+
+private:
+  struct Job
+  {
+    BeatFrameState frame;
+    ThemeColors theme;
+    juce::uint32 themeGeneration = 0;
+    int width = 0;
+    int height = 0;
+    float scale = 1.0f;
+  };
+
+  void run() override;
+  void applyJob(const Job& job);
+  bool rasterise(const Job& job); // false if the target image is still being blitted
+
+  TripleBuffer<Job> jobs;
+
+  // Owned by the render thread once it has started.
+  TrafficVisualizer visualizer;
+  std::array<juce::Image, 2> images;
+
+  std::atomic<int> publishedIndex { -1 };
+  std::atomic<int> readingIndex { -1 };
+  std::atomic<juce::uint32> completedFrames { 0 };
+  std::atomic<bool> animating { false };
+
+  // Message thread only.
+  Job lastSubmitted;
+  bool hasSubmitted = false;
+  float lastPaintScale = 1.0f;
+  juce::Colour backgroundColour { juce::Colours::black };
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ThreadedTrafficView)
+};
@@ -0,0 +1,115 @@
+#include "TiledRenderer.h"
+#include "TraceRecorder.h"
+
+#include <cmath>
+
+namespace
+{
+// Bands shorter than this cost more in per-band setup than they win in parallelism.
+constexpr int kMinBandHeightPx = 96;
+
+int resolveNumThreads(int requested)
+{
+  return requested > 0 ? requested : juce::jmax(1, juce::SystemStats::getNumCpus());
+}
+} // namespace
+
+class TiledRenderer::BandJob final : public juce::ThreadPoolJob
+{
+public:
+  BandJob(TiledRenderer& ownerToUse, size_t bandIndex)
+      : juce::ThreadPoolJob("VizBeats band"), owner(ownerToUse), index(bandIndex)
+  {
+  }
+
+  JobStatus runJob() override
+  {
+    owner.renderBand(index);
+    return jobHasFinished;
+  }
+
+private:
+  TiledRenderer& owner;
+  const size_t index;
+};
+
+TiledRenderer::TiledRenderer(int numThreads)
+    : numWorkers(resolveNumThreads(numThreads)),
+      pool(juce::ThreadPoolOptions {}
+               .withThreadName("VizBeats tiles")
+               .withNumberOfThreads(numWorkers))
+{
+  // One band per worker plus one for the calling thread; jobs and band images are reused.
+  const auto maxBands = static_cast<size_t>(numWorkers + 1);
+  bands.resize(maxBands);
+  jobs.reserve(maxBands);
+  for (size_t i = 0; i < maxBands; ++i)
+    jobs.push_back(std::make_unique<BandJob>(*this, i));
+}
+
+TiledRenderer::~TiledRenderer()
+{
+  pool.removeAllJobs(true, 1000);
+}
+
+bool TiledRenderer::shouldTile(int width, int height, float scale) const noexcept
+{
+  juce::ignoreUnused(width);
+  return static_cast<float>(height) * scale >= static_cast<float>(kMinBandHeightPx * 2);
+}
+
+void TiledRenderer::render(juce::Graphics& g, int width, int height, float scale, const PaintFunction& paint)
+{
+  const auto w = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(width) * scale)));
+  const auto h = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(height) * scale)));
+  const auto numBands = static_cast<size_t>(juce::jlimit(1, static_cast<int>(bands.size()), h / kMinBandHeightPx));
+
+  // Split rows evenly; earlier bands absorb the remainder.
+  const auto rowsPerBand = h / static_cast<int>(numBands);
+  const auto extraRows = h % static_cast<int>(numBands);
+  int y = 0;
+
+  for (size_t i = 0; i < numBands; ++i)
+  {
+    const auto rows = rowsPerBand + (static_cast<int>(i) < extraRows ? 1 : 0);
+    auto& band = bands[i];
+    band.y = y;
+    if (band.image.getWidth() != w || band.image.getHeight() != rows)
+      band.image = juce::Image(juce::Image::ARGB, w, rows, false, juce::SoftwareImageType());
+
+    y += rows;
+  }
+
+  currentPaint = &paint;
+  currentScale = scale;
+
+  for (size_t i = 1; i < numBands; ++i)
+    pool.addJob(jobs[i].get(), false);
+
+  renderBand(0);
+
+  for (size_t i = 1; i < numBands; ++i)
+    pool.waitForJobToFinish(jobs[i].get(), -1);
+
+  currentPaint = nullptr;
+
+  for (size_t i = 0; i < numBands; ++i)
+  {
+    const auto& band = bands[i];
+    g.drawImageTransformed(band.image, juce::AffineTransform::translation(0.0f, static_cast<float>(band.y)).scaled(1.0f / scale));
+  }
+}
+
+void TiledRenderer::renderBand(size_t index)
+{
+  const ScopedTrace trace("TiledRenderer::renderBand");
+  auto& band = bands[index];
+  if (currentPaint == nullptr || band.image.isNull())
+    return;
+
+  band.image.clear(band.image.getBounds());
+
+  juce::Graphics g(band.image);
+  g.addTransform(juce::AffineTransform::scale(currentScale).translated(0.0f, -static_cast<float>(band.y)));
+  (*currentPaint)(g);
+}
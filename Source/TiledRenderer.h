@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Splits a software-rendered frame into horizontal bands and rasterises them in parallel on a
+// thread pool.
+//
+// Every band runs the same paint function into its own band image with the canvas shifted
+// up, so the result matches a single-threaded paint pixel for pixel; the bands are then
+// blitted into the destination. The paint function must be safe to call concurrently, i.e.
+// only read shared state (caches are prepared before render()).
+class TiledRenderer
+{
+public:
+  using PaintFunction = std::function<void(juce::Graphics&)>;
+
+  // numThreads <= 0 uses one worker per CPU core (the calling thread renders a band too).
+  explicit TiledRenderer(int numThreads = 0);
+  ~TiledRenderer();
+
+  // True if a frame of this logical size and scale is tall enough to be worth splitting.
+  bool shouldTile(int width, int height, float scale) const noexcept;
+
+  // Renders a width x height (logical) frame at the given physical scale into g.
+  void render(juce::Graphics& g, int width, int height, float scale, const PaintFunction& paint);
+
+  int getNumWorkers() const noexcept { return numWorkers; }
+
+private:
+  class BandJob;
+
+  struct Band
+  {
+    juce::Image image;
+    int y = 0;
+  };
+
+  void renderBand(size_t index);
+
+  int numWorkers = 1;
+  juce::ThreadPool pool;
+  std::vector<std::unique_ptr<BandJob>> jobs;
+  std::vector<Band> bands;
+
+  // Valid only while render() runs.
+  const PaintFunction* currentPaint = nullptr;
+  float currentScale = 1.0f;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TiledRenderer)
+};
@@ -0,0 +1,165 @@
+#include "TraceRecorder.h"
+
+#include <cstring>
+
+namespace
+{
+juce::String toMicroseconds(juce::int64 ticks)
+{
+  return juce::String(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6, 3);
+}
+} // namespace
+
+TraceRecorder& TraceRecorder::getInstance()
+{
+  static TraceRecorder instance;
+  return instance;
+}
+
+void TraceRecorder::start()
+{
+  JUCE_ASSERT_MESSAGE_THREAD
+
+  recording.store(false, std::memory_order_release);
+
+  // Buffers are allocated on the first capture and kept, so a thread that still holds a
+  // buffer from the previous capture never writes into freed memory.
+  for (auto& buffer : buffers)
+  {
+    if (buffer.events == nullptr)
+      buffer.events = std::make_unique<Event[]>(static_cast<size_t>(eventsPerThread));
+
+    buffer.numEvents.store(0, std::memory_order_relaxed);
+    buffer.dropped.store(0, std::memory_order_relaxed);
+    buffer.threadId = 0;
+    buffer.threadName[0] = 0;
+  }
+
+  numClaimed.store(0, std::memory_order_relaxed);
+  startTicks = juce::Time::getHighResolutionTicks();
+
+  // Threads notice the new generation and claim a fresh buffer on their next event.
+  generation.fetch_add(1, std::memory_order_release);
+  recording.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop()
+{
+  JUCE_ASSERT_MESSAGE_THREAD
+  recording.store(false, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::claimBuffer() noexcept
+{
+  thread_local juce::uint32 claimedGeneration = 0;
+  thread_local ThreadBuffer* claimed = nullptr;
+
+  const auto currentGeneration = generation.load(std::memory_order_acquire);
+  if (claimedGeneration == currentGeneration)
+    return claimed;
+
+  claimedGeneration = currentGeneration;
+  claimed = nullptr;
+
+  const auto index = numClaimed.fetch_add(1, std::memory_order_relaxed);
+  if (index >= maxThreads)
+    return nullptr; // More threads than buffers: this one isn't traced.
+
+  auto& buffer = buffers[static_cast<size_t>(index)];
+  buffer.threadId = static_cast<juce::uint64>(reinterpret_cast<juce::pointer_sized_uint>(juce::Thread::getCurrentThreadId()));
+
+  // No allocation here: this may be the host's audio thread, so literals are copied directly
+  // rather than through a juce::String.
+  const auto copyName = [&buffer](const char* name)
+  {
+    std::strncpy(buffer.threadName, name, sizeof(buffer.threadName) - 1);
+    buffer.threadName[sizeof(buffer.threadName) - 1] = 0;
+  };
+
+  auto* messageManager = juce::MessageManager::getInstanceWithoutCreating();
+  if (messageManager != nullptr && messageManager->isThisTheMessageThread())
+    copyName("Message thread");
+  else if (auto* thread = juce::Thread::getCurrentThread())
+    thread->getThreadName().copyToUTF8(buffer.threadName, sizeof(buffer.threadName));
+  else
+    copyName("Host thread");
+
+  claimed = &buffer;
+  return claimed;
+}
+
+void TraceRecorder::record(const char* name, juce::int64 eventStartTicks, juce::int64 eventEndTicks) noexcept
+{
+  // A scope that began before stop() ends after it: nothing may be written once the capture
+  // has stopped, or while start() is resetting the buffers.
+  if (!isRecording())
+    return;
+
+  auto* buffer = claimBuffer();
+  if (buffer == nullptr)
+    return;
+
+  const auto index = buffer->numEvents.load(std::memory_order_relaxed);
+  if (index >= eventsPerThread)
+  {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  buffer->events[static_cast<size_t>(index)] = { name, eventStartTicks, eventEndTicks };
+  buffer->numEvents.store(index + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::writeJson(const juce::File& file) const
+{
+  JUCE_ASSERT_MESSAGE_THREAD
+
+  juce::FileOutputStream out(file);
+  if (!out.openedOk())
+    return false;
+
+  out.setPosition(0);
+  out.truncate();
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  bool first = true;
+  const auto separator = [&out, &first]
+  {
+    if (!first)
+      out << ",\n";
+    first = false;
+  };
+
+  const auto numThreads = juce::jmin(maxThreads, numClaimed.load(std::memory_order_relaxed));
+  for (int t = 0; t < numThreads; ++t)
+  {
+    const auto& buffer = buffers[static_cast<size_t>(t)];
+    const auto numEvents = buffer.numEvents.load(std::memory_order_acquire);
+    const auto dropped = buffer.dropped.load(std::memory_order_relaxed);
+    const auto tid = t + 1;
+
+    juce::String threadName(juce::CharPointer_UTF8(buffer.threadName));
+    if (dropped > 0)
+      threadName << " (dropped " << static_cast<int>(dropped) << " events)";
+
+    separator();
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+        << ",\"args\":{\"name\":" << juce::JSON::toString(juce::var(threadName))
+        << ",\"os_thread_id\":" << juce::String(static_cast<juce::int64>(buffer.threadId)) << "}}";
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+      const auto& e = buffer.events[static_cast<size_t>(i)];
+
+      separator();
+      out << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+          << ",\"ts\":" << toMicroseconds(e.startTicks - startTicks)
+          << ",\"dur\":" << toMicroseconds(e.endTicks - e.startTicks) << '}';
+    }
+  }
+
+  out << "\n]}\n";
+  out.flush();
+  return out.getStatus().wasOk();
+}
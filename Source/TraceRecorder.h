@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+// Process-wide capture of timed scopes from every thread (audio, message, render workers),
+// exported as Chrome trace-event JSON for chrome://tracing or ui.perfetto.dev.
+//
+// Off by default. While off, a ScopedTrace costs one relaxed atomic load. While recording,
+// each thread appends to its own preallocated buffer (claimed lock-free on its first event),
+// so recording never locks or allocates. A full buffer drops further events from that thread.
+class TraceRecorder
+{
+public:
+  static TraceRecorder& getInstance();
+
+  static bool isRecording() noexcept { return recording.load(std::memory_order_relaxed); }
+
+  // Message thread. start() clears the previous capture.
+  void start();
+  void stop();
+
+  // Message thread, after stop().
+  bool writeJson(const juce::File& file) const;
+
+  // `name` must be a string literal (only the pointer is stored). Ignored while not recording.
+  void record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+
+private:
+  TraceRecorder() = default;
+
+  static constexpr int maxThreads = 16;
+  static constexpr int eventsPerThread = 32768;
+
+  struct Event
+  {
+    const char* name;
+    juce::int64 startTicks;
+    juce::int64 endTicks;
+  };
+
+  struct ThreadBuffer
+  {
+    std::unique_ptr<Event[]> events;
+    std::atomic<int> numEvents { 0 };
+    std::atomic<juce::uint32> dropped { 0 };
+    juce::uint64 threadId = 0;
+    char threadName[48] {};
+  };
+
+  ThreadBuffer* claimBuffer() noexcept;
+
+  inline static std::atomic<bool> recording { false };
+
+  std::array<ThreadBuffer, maxThreads> buffers;
+  std::atomic<int> numClaimed { 0 };
+  std::atomic<juce::uint32> generation { 0 };
+  juce::int64 startTicks = 0;
+
+  JUCE_DECLARE_NON_COPYABLE(TraceRecorder)
+};
+
+// Records the enclosing scope into the TraceRecorder while it is recording.
+class ScopedTrace
+{
+public:
+  explicit ScopedTrace(const char* n) noexcept
+      : name(n), startTicks(TraceRecorder::isRecording() ? juce::Time::getHighResolutionTicks() : 0)
+  {
+  }
+
+  ~ScopedTrace()
+  {
+    if (startTicks != 0)
+      TraceRecorder::getInstance().record(name, startTicks, juce::Time::getHighResolutionTicks());
+  }
+
+private:
+  const char* name;
+  juce::int64 startTicks;
+
+  JUCE_DECLARE_NON_COPYABLE(ScopedTrace)
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// A value that only counts as changed when it actually differs from what it held before.
+// Every accepted change bumps a generation counter, so consumers can remember the last
+// generation they applied and skip work (and repaints) when nothing moved.
+template <typename T>
+class TrackedValue
+{
+public:
+  // Returns true if the value changed (the first assignment always counts as a change).
+  bool set(const T& newValue)
+  {
+    if (generation != 0 && newValue == value)
+      return false;
+
+    value = newValue;
+    ++generation;
+    return true;
+  }
+
+  const T& get() const noexcept { return value; }
+  juce::uint32 getGeneration() const noexcept { return generation; }
+
+private:
+  T value {};
+  juce::uint32 generation = 0;
+};
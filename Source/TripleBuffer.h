@@ -0,0 +1,47 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+
+// Lock-free "latest value" hand-off between one writer thread and one reader thread.
+//
+// The writer fills its private slot and publishes it by swapping it with the shared middle
+// slot; the reader swaps the middle slot with its own when something new was published.
+// Neither side ever waits, and the reader always sees the most recent complete value.
+template <typename T>
+class TripleBuffer
+{
+public:
+  // Writer: fill this, then call publish().
+  T& getWriteBuffer() noexcept { return buffers[static_cast<size_t>(writeIndex)]; }
+
+  void publish() noexcept
+  {
+    const auto previous = middle.exchange(writeIndex | freshFlag, std::memory_order_acq_rel);
+    writeIndex = previous & indexMask;
+  }
+
+  // Reader: returns true if a newer value was published since the last call.
+  bool update() noexcept
+  {
+    if ((middle.load(std::memory_order_relaxed) & freshFlag) == 0)
+      return false;
+
+    const auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+    readIndex = previous & indexMask;
+    return true;
+  }
+
+  const T& getReadBuffer() const noexcept { return buffers[static_cast<size_t>(readIndex)]; }
+
+private:
+  static constexpr int indexMask = 3;
+  static constexpr int freshFlag = 4;
+
+  std::array<T, 3> buffers {};
+  int writeIndex = 0;
+  int readIndex = 1;
+  std::atomic<int> middle { 2 };
+};
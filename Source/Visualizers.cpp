@@ -0,0 +1,590 @@
+#include "Visualizers.h"
+#include "TiledRenderer.h"
+#include "TraceRecorder.h"
+
+#include <cmath>
+
+namespace
+{
+// How far into beat 1 a jump may land and still count as arriving on the bar line (a UI frame
+// plus an audio block, with room to spare).
+constexpr double kJumpDownbeatWindowBeats = 0.25;
+
+// Polyrhythm lane rows alternate below and above the beat line, moving outwards; eight lanes
+// stay inside the side bars.
+constexpr float kFirstLaneOffset = 16.0f;
+constexpr float kLaneSpacing = 14.0f;
+
+float clamp01(float v)
+{
+  return juce::jlimit(0.0f, 1.0f, v);
+}
+
+// Ambient wash for the bar flash: a smooth fade from the left edge, dithered against banding.
+// Deterministic for a given size and theme, so one image serves every visualizer.
+juce::Image renderFlashOverlay(int w, int h, juce::uint64 flashKey, juce::Colour accent)
+{
+  juce::Image overlay(juce::Image::ARGB, w, h, true);
+  juce::Image::BitmapData bd(overlay, juce::Image::BitmapData::writeOnly);
+
+  const float wf = static_cast<float>(w);
+
+  // Smooth ambient wash - gradual fade from left edge to center
+  const float fadeWidth = wf * 0.45f; // How far the glow extends horizontally
+
+  const float ditherScale = 1.5f / 255.0f;
+  const auto seed = static_cast<juce::uint32>((flashKey >> 32) ^ (flashKey & 0xffffffffu));
+  juce::Random rng(static_cast<int>(seed));
+
+  for (int py = 0; py < h; ++py)
+  {
+    for (int px = 0; px < w; ++px)
+    {
+      const float x = static_cast<float>(px);
+
+      // Simple horizontal fade from left edge
+      float horizontalFade = 1.0f - (x / fadeWidth);
+      horizontalFade = juce::jmax(0.0f, horizontalFade);
+      // Smooth cubic falloff for natural look
+      horizontalFade = horizontalFade * horizontalFade * (3.0f - 2.0f * horizontalFade);
+
+      float a = horizontalFade * 0.50f; // Max alpha at left edge - more kick!
+
+      if (a < 0.002f)
+      {
+        bd.setPixelColour(px, py, juce::Colours::transparentBlack);
+        continue;
+      }
+
+      // Add subtle dithering to prevent banding
+      a += (rng.nextFloat() - 0.5f) * ditherScale;
+      a = clamp01(a);
+
+      bd.setPixelColour(px, py, accent.withAlpha(a));
+    }
+  }
+
+  return overlay;
+}
+} // namespace
+
+//==============================================================================
+ModeVisualizer::ModeVisualizer(std::unique_ptr<BeatModeRenderer> modeRenderer)
+    : renderer(std::move(modeRenderer))
+{
+  jassert(renderer != nullptr);
+  setOpaque(true);
+}
+
+void ModeVisualizer::applyFrameState(const BeatFrameState& state)
+{
+  const bool layoutChanged = state.beatsPerBar != frame.beatsPerBar || state.subdivisions != frame.subdivisions;
+
+  frame = state;
+  frame.beatsPerBar = juce::jmax(1, state.beatsPerBar);
+  frame.subdivisions = juce::jmax(1, state.subdivisions);
+  renderer->advance(frame);
+
+  if (layoutChanged)
+    repaint();
+}
+
+void ModeVisualizer::updateStaticLayer(float scale)
+{
+  const LayerCacheKey key { getWidth(), getHeight(), scale, themeGeneration, frame.beatsPerBar, frame.subdivisions, 0 };
+  if (staticLayer.isValid() && key == staticLayerKey)
+    return;
+
+  staticLayerKey = key;
+
+  const auto w = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(getWidth()) * scale)));
+  const auto h = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(getHeight()) * scale)));
+  if (staticLayer.getWidth() != w || staticLayer.getHeight() != h)
+    staticLayer = juce::Image(juce::Image::RGB, w, h, false, juce::SoftwareImageType());
+
+  juce::Graphics g(staticLayer);
+  g.addTransform(juce::AffineTransform::scale(scale));
+
+  const BeatModeContext context { getLocalBounds().toFloat(), theme, frame, scale };
+  renderer->paintStaticLayer(g, context);
+}
+
+void ModeVisualizer::paintFrame(juce::Graphics& g, float scale)
+{
+  g.drawImageTransformed(staticLayer, juce::AffineTransform::scale(1.0f / scale));
+
+  const BeatModeContext context { getLocalBounds().toFloat(), theme, frame, scale };
+  renderer->paintDynamicLayer(g, context);
+}
+
+void ModeVisualizer::paint(juce::Graphics& g)
+{
+  const ScopedTrace trace("ModeVisualizer::paint");
+  const FrameProfiler::ScopedTimer paintTimer(profiler, FrameProfiler::Channel::ModePaint);
+  const auto startTicks = juce::Time::getHighResolutionTicks();
+
+  const auto physicalScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+  const auto scale = juce::jlimit(0.5f, 4.0f, physicalScale * frame.quality.resolutionScale);
+  updateStaticLayer(scale);
+
+  if (frame.quality.resolutionScale < 1.0f)
+  {
+    // Reduced quality: render at a lower internal resolution and upscale the result.
+    const auto w = staticLayer.getWidth();
+    const auto h = staticLayer.getHeight();
+    if (lowResFrame.getWidth() != w || lowResFrame.getHeight() != h)
+      lowResFrame = juce::Image(juce::Image::RGB, w, h, false, juce::SoftwareImageType());
+
+    {
+      juce::Graphics lowResGraphics(lowResFrame);
+      lowResGraphics.addTransform(juce::AffineTransform::scale(scale));
+      paintFrame(lowResGraphics, scale);
+    }
+
+    g.setImageResamplingQuality(juce::Graphics::mediumResamplingQuality);
+    g.drawImage(lowResFrame, getLocalBounds().toFloat());
+  }
+  else
+  {
+    lowResFrame = {};
+    paintFrame(g, scale);
+  }
+
+  if (governor != nullptr)
+    governor->recordPaintTime(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+}
+
+//==============================================================================
+TrafficVisualizer::Layout TrafficVisualizer::getLayout(juce::Rectangle<float> bounds)
+{
+  Layout l;
+  l.centreY = bounds.getCentreY();
+  l.lineStartX = 88.0f;
+  l.lineEndX = bounds.getWidth() - 88.0f;
+  l.lineWidth = l.lineEndX - l.lineStartX;
+  l.barY = l.centreY - l.barHeight * 0.5f;
+  return l;
+}
+
+float TrafficVisualizer::getLaneRowY(const Layout& l, int row)
+{
+  const auto offset = kFirstLaneOffset + kLaneSpacing * static_cast<float>(row / 2);
+  return l.centreY + ((row % 2) == 0 ? offset : -offset);
+}
+
+float TrafficVisualizer::getBarProgress01() const
+{
+  // Orb position: constant speed across the whole bar.
+  return running
+             ? clamp01(static_cast<float>((static_cast<double>(currentBeat) + beatPhase) / static_cast<double>(beatsPerBar)))
+             : 0.0f;
+}
+
+void TrafficVisualizer::advanceAnimation()
+{
+  float dtSeconds = 0.0f;
+  if (lastAdvanceTimeSeconds >= 0.0)
+    dtSeconds = juce::jlimit(0.0f, 0.10f, static_cast<float>(frameTimeSeconds - lastAdvanceTimeSeconds));
+  lastAdvanceTimeSeconds = frameTimeSeconds;
+
+  const float barProgress01 = getBarProgress01();
+
+  // Main beat segments (for ripples only)
+  const int mainBeatSegments = juce::jmax(1, beatsPerBar);
+  const float orbMainBeatSpace = barProgress01 * static_cast<float>(mainBeatSegments);
+
+  // Decaying left flash pulse (triggered on bar wrap).
+  if (dtSeconds > 0.0f && leftFlash > 0.0f)
+  {
+    leftFlash *= std::exp(-dtSeconds * 6.5f);
+    if (leftFlash < 0.001f)
+      leftFlash = 0.0f;
+  }
+
+  // A seek or loop re-seeds the bar count. It only flashes when it lands on a downbeat (a loop
+  // back to a bar line); ripples from before the jump are dropped.
+  const bool jumped = discontinuityGeneration != lastDiscontinuityGeneration;
+  const bool newBar = lastBarIndexValid && barIndex != lastBarIndex;
+  lastDiscontinuityGeneration = discontinuityGeneration;
+
+  bool barWrapped = false;
+  if (running)
+  {
+    if (jumped)
+      barWrapped = currentBeat == 0 && beatPhase < kJumpDownbeatWindowBeats;
+    else
+      barWrapped = lastBarIndexValid && barIndex == lastBarIndex + 1;
+
+    lastBarIndex = barIndex;
+    lastBarIndexValid = true;
+
+    if (barWrapped)
+      leftFlash = 1.0f;
+  }
+  else
+  {
+    lastBarIndexValid = false;
+    leftFlash = 0.0f;
+  }
+
+  // Ripples are pushed in time order, so expired ones are always at the head.
+  while (!ripples.isEmpty() && frameTimeSeconds - ripples.front().birthTimeSeconds >= OrbSpriteAtlas::rippleLifeSeconds)
+    ripples.popFront();
+
+  // Ripples: emit when orb passes a MAIN BEAT marker only (not subdivisions).
+  if (running)
+  {
+    if (lastOrbMarkerSpace < 0.0f || jumped)
+    {
+      if (jumped)
+        ripples.clear();
+
+      lastOrbMarkerSpace = orbMainBeatSpace;
+    }
+    else
+    {
+      if (newBar)
+      {
+        ripples.clear();
+      }
+      else
+      {
+        const int lastIdx = static_cast<int>(std::floor(lastOrbMarkerSpace));
+        const int nowIdx = static_cast<int>(std::floor(orbMainBeatSpace));
+        for (int i = lastIdx + 1; i <= nowIdx; ++i)
+        {
+          // Ripples only at main beat positions; a full buffer drops its oldest ripple.
+          ripples.push({ juce::jlimit(0, mainBeatSegments, i), frameTimeSeconds });
+        }
+      }
+      lastOrbMarkerSpace = orbMainBeatSpace;
+    }
+  }
+  else
+  {
+    lastOrbMarkerSpace = -1.0f;
+    ripples.clear();
+  }
+}
+
+void TrafficVisualizer::applyFrameState(const BeatFrameState& state)
+{
+  setRunning(state.running);
+  setBeatPhase(state.beatPhase);
+  setBeatsPerBar(state.beatsPerBar);
+  setSubdivisions(state.subdivisions);
+  setCurrentBeat(state.currentBeat);
+  setPolyrhythmLanes(state.lanes);
+  setBarIndex(state.barIndex);
+  setDiscontinuityGeneration(state.discontinuityGeneration);
+  setFrameTime(state.frameTimeSeconds);
+  setQuality(state.quality);
+  advanceAnimation();
+}
+
+void TrafficVisualizer::updateMarkerLayer(juce::Rectangle<float> bounds, float scale)
+{
+  const LayerCacheKey key { getWidth(), getHeight(), scale, themeGeneration, beatsPerBar, subdivisions, lanesGeneration };
+  if (markerLayer.isValid() && key == markerLayerKey)
+    return;
+
+  markerLayerKey = key;
+
+  const auto w = juce::jmax(1, static_cast<int>(std::ceil(bounds.getWidth() * scale)));
+  const auto h = juce::jmax(1, static_cast<int>(std::ceil(bounds.getHeight() * scale)));
+  markerLayer = juce::Image(juce::Image::ARGB, w, h, true, juce::SoftwareImageType());
+
+  juce::Graphics g(markerLayer);
+  g.addTransform(juce::AffineTransform::scale(scale));
+
+  const auto l = getLayout(bounds);
+
+  // Baseline line (drawn above the flash wash so it stays crisp).
+  g.setColour(theme.textMuted.withAlpha(0.22f));
+  g.drawLine(l.lineStartX, l.centreY, l.lineEndX, l.centreY, 1.0f);
+
+  // Side bars: keep both bars the same colour; only the left bar receives a hit overlay per frame.
+  constexpr float baseAlpha = 0.35f;
+  g.setColour(theme.barMarker.withAlpha(baseAlpha));
+  g.fillRect(l.lineStartX - l.barWidth - 10.0f, l.barY, l.barWidth, l.barHeight);
+  g.fillRect(l.lineEndX + 10.0f, l.barY, l.barWidth, l.barHeight);
+
+  // Total visual segments (beats * subdivisions for visual markers)
+  const int totalSegments = juce::jmax(1, beatsPerBar * subdivisions);
+  const float markerSpacing = l.lineWidth / static_cast<float>(totalSegments);
+
+  // Draw all visual markers (main beats + subdivisions)
+  for (int i = 0; i <= totalSegments; ++i)
+  {
+    const float x = l.lineStartX + static_cast<float>(i) * markerSpacing;
+
+    // No end-circles near the side bars (matches reference).
+    if (i == 0 || i == totalSegments)
+      continue;
+
+    // Main beats are larger, subdivisions are smaller
+    const bool isMainBeat = (i % subdivisions) == 0;
+    const float size = isMainBeat ? 7.0f : 4.5f;
+    const float stroke = isMainBeat ? 1.3f : 0.9f;
+    const float alpha = isMainBeat ? 0.35f : 0.20f;
+
+    // ring markers stay static (no proximity glow); ripples handle "hit" feedback.
+    g.setColour(theme.textMuted.withAlpha(alpha));
+    g.drawEllipse(x - size * 0.5f, l.centreY - size * 0.5f, size, size, stroke);
+  }
+
+  // Polyrhythm lanes: a faint guide line per lane with its pulses, accented ones filled.
+  int row = 0;
+  for (const auto& lane : lanes.lanes)
+  {
+    if (!lane.isActive())
+      continue;
+
+    const float y = getLaneRowY(l, row++);
+    const float pulseSpacing = l.lineWidth / static_cast<float>(lane.pulses);
+
+    g.setColour(theme.accentSecondary.withAlpha(0.10f));
+    g.drawLine(l.lineStartX, y, l.lineEndX, y, 1.0f);
+
+    for (int i = 1; i < lane.pulses; ++i)
+    {
+      const float x = l.lineStartX + static_cast<float>(i) * pulseSpacing;
+
+      if (lane.isAccented(i))
+      {
+        g.setColour(theme.accentSecondary.withAlpha(0.45f));
+        g.fillEllipse(x - 2.5f, y - 2.5f, 5.0f, 5.0f);
+      }
+      else
+      {
+        g.setColour(theme.accentSecondary.withAlpha(0.28f));
+        g.drawEllipse(x - 2.0f, y - 2.0f, 4.0f, 4.0f, 0.9f);
+      }
+    }
+  }
+}
+
+void TrafficVisualizer::updateFlashOverlay(int w, int h)
+{
+  const auto bgArgb = theme.background.getARGB();
+  const auto accentArgb = theme.accent.getARGB();
+  const auto accent2Argb = theme.accentSecondary.getARGB();
+  const auto flashKey =
+      (static_cast<juce::uint64>(bgArgb) << 32)
+      ^ static_cast<juce::uint64>(accentArgb)
+      ^ (static_cast<juce::uint64>(accent2Argb) << 1);
+
+  const FlashOverlayKey key { w, h, flashKey };
+  if (leftFlashOverlay != nullptr && key == leftFlashOverlayKey)
+    return;
+
+  leftFlashOverlayKey = key;
+
+  const auto accent = theme.accent;
+  leftFlashOverlay = flashOverlayCache->get(key, [w, h, flashKey, accent]
+  {
+    return std::make_shared<juce::Image>(renderFlashOverlay(w, h, flashKey, accent));
+  });
+}
+
+void TrafficVisualizer::paint(juce::Graphics& g)
+{
+  const ScopedTrace trace("TrafficVisualizer::paint");
+  const FrameProfiler::ScopedTimer paintTimer(profiler, FrameProfiler::Channel::TrafficPaint);
+  const auto startTicks = juce::Time::getHighResolutionTicks();
+
+  const auto physicalScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+  const auto scale = juce::jlimit(0.5f, 4.0f, physicalScale * quality.resolutionScale);
+  prepareLayers(scale);
+
+  if (quality.resolutionScale < 1.0f)
+  {
+    // Reduced quality: render at a lower internal resolution and upscale the result.
+    const auto w = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(getWidth()) * scale)));
+    const auto h = juce::jmax(1, static_cast<int>(std::ceil(static_cast<float>(getHeight()) * scale)));
+    if (lowResFrame.getWidth() != w || lowResFrame.getHeight() != h)
+      lowResFrame = juce::Image(juce::Image::RGB, w, h, false, juce::SoftwareImageType());
+
+    {
+      juce::Graphics lowResGraphics(lowResFrame);
+      lowResGraphics.addTransform(juce::AffineTransform::scale(scale));
+      paintFrame(lowResGraphics, scale);
+    }
+
+    g.setImageResamplingQuality(juce::Graphics::mediumResamplingQuality);
+    g.drawImage(lowResFrame, getLocalBounds().toFloat());
+  }
+  else
+  {
+    lowResFrame = {};
+    paintFrame(g, scale);
+  }
+
+  if (governor != nullptr)
+    governor->recordPaintTime(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+}
+
+void TrafficVisualizer::paintFrame(juce::Graphics& g, float scale)
+{
+  if (tiledRenderer != nullptr && tiledRenderer->shouldTile(getWidth(), getHeight(), scale))
+    tiledRenderer->render(g, getWidth(), getHeight(), scale, [this](juce::Graphics& band) { paintLayers(band); });
+  else
+    paintLayers(g);
+}
+
+void TrafficVisualizer::prepareLayers(float scale)
+{
+  const auto bounds = getLocalBounds().toFloat();
+
+  updateMarkerLayer(bounds, scale);
+
+  if (leftFlash > 0.0f && quality.softGlow)
+    updateFlashOverlay(juce::jmax(1, static_cast<int>(std::round(bounds.getWidth()))),
+                       juce::jmax(1, static_cast<int>(std::round(bounds.getHeight()))));
+
+  const auto atlasKey = OrbSpriteAtlas::makeKey(theme, scale);
+  if (spriteAtlas == nullptr || spriteAtlas->getKey() != atlasKey)
+  {
+    const auto& colors = theme;
+    spriteAtlas = spriteAtlasCache->get(atlasKey, [&colors, scale]
+    {
+      auto atlas = std::make_shared<OrbSpriteAtlas>();
+      atlas->prepare(colors, scale);
+      return atlas;
+    });
+  }
+}
+
+void TrafficVisualizer::paintLayers(juce::Graphics& g) const
+{
+  // Everything here draws from state prepared by advanceAnimation() and the cached layers, so
+  // a steady-state frame builds no paths, gradients, fonts or strings, and tiled rendering
+  // can run this on several bands at once.
+  const auto bounds = getLocalBounds().toFloat();
+  const auto l = getLayout(bounds);
+
+  // Background: use the theme base colour (no left-side brightening).
+  g.setColour(theme.background);
+  g.fillRect(bounds);
+
+  const float barProgress01 = getBarProgress01();
+  const int mainBeatSegments = juce::jmax(1, beatsPerBar);
+  const float mainBeatMarkerSpacing = l.lineWidth / static_cast<float>(mainBeatSegments);
+
+  // Track orb position relative to main beats only (for ripples)
+  const float orbMainBeatSpace = barProgress01 * static_cast<float>(mainBeatSegments);
+  const float orbX = l.lineStartX + barProgress01 * l.lineWidth;
+  const float orbY = l.centreY;
+
+  // Orb brightens near main beat markers only ("activation" feel).
+  const float distToNearest = std::abs(orbMainBeatSpace - std::round(orbMainBeatSpace));
+  const float hit = running ? std::exp(-distToNearest * distToNearest * 110.0f) : 0.0f;
+
+  const float leftPulse = leftFlash;
+
+  // Keep a small "hit" pulse at the right bar for the orb only (right bar itself should not light up).
+  float rightPulse = 0.0f;
+  if (running)
+  {
+    const auto pulseFromDistance = [](float distPx, float sigmaPx)
+    {
+      if (sigmaPx <= 0.0f)
+        return 0.0f;
+
+      const float x = distPx / sigmaPx;
+      float v = std::exp(-0.5f * x * x);
+      v *= v;
+      return clamp01(v);
+    };
+
+    const auto gate = [](float v, float threshold)
+    {
+      if (v <= threshold)
+        return 0.0f;
+      return clamp01((v - threshold) / (1.0f - threshold));
+    };
+
+    const float rightHit = pulseFromDistance(std::abs(orbX - l.lineEndX), 14.0f);
+    rightPulse = gate(rightHit, 0.10f);
+  }
+
+  // Left-side screen flash (momentary) when the ball reaches the left bar.
+  if (leftPulse > 0.0f && quality.softGlow)
+  {
+    g.setOpacity(clamp01(leftPulse) * 0.85f);
+    g.drawImageAt(*leftFlashOverlay, 0, 0);
+  }
+
+  // Baseline, side bars and beat markers only change with size/theme/meter.
+  g.setOpacity(1.0f);
+  g.drawImageTransformed(markerLayer, juce::AffineTransform::scale(1.0f / markerLayerKey.scale));
+
+  // Subtle left bar highlight when hit
+  if (leftPulse > 0.0f)
+  {
+    g.setColour(theme.barMarker.withAlpha(0.25f * clamp01(leftPulse)));
+    g.fillRect(l.lineStartX - l.barWidth - 10.0f, l.barY, l.barWidth, l.barHeight);
+  }
+
+  // Ripples, tail, halo and orb are blits from the pre-rendered sprite atlas.
+  // Draw ripples after markers.
+  // Reduced quality draws only the newest ripples.
+  const auto rippleLimit = static_cast<size_t>(juce::jmax(0, quality.maxRipples));
+  const auto firstRipple = ripples.size() > rippleLimit ? ripples.size() - rippleLimit : size_t { 0 };
+
+  for (size_t i = firstRipple; i < ripples.size(); ++i)
+  {
+    const auto& r = ripples[i];
+    const float x = l.lineStartX + static_cast<float>(r.beatIndex) * mainBeatMarkerSpacing;
+    const auto age01 = static_cast<float>((frameTimeSeconds - r.birthTimeSeconds) / OrbSpriteAtlas::rippleLifeSeconds);
+    spriteAtlas->drawRipple(g, { x, l.centreY }, clamp01(age01));
+  }
+
+  // Lane hits: the pulse each lane last passed lights up and fades over the pulse. Plain
+  // rectangles, so the frame still builds no paths.
+  if (running)
+  {
+    int row = 0;
+    for (const auto& lane : lanes.lanes)
+    {
+      if (!lane.isActive())
+        continue;
+
+      const float y = getLaneRowY(l, row++);
+      const float pulseSpace = barProgress01 * static_cast<float>(lane.pulses);
+      const float pulse = std::floor(pulseSpace);
+      const float fade = 1.0f - (pulseSpace - pulse);
+      const float x = l.lineStartX + pulse * l.lineWidth / static_cast<float>(lane.pulses);
+
+      g.setColour(theme.accentSecondary.withAlpha((lane.isAccented(static_cast<int>(pulse)) ? 0.90f : 0.60f) * fade * fade));
+      g.fillRect(x - 1.5f, y - 5.0f, 3.0f, 10.0f);
+    }
+  }
+
+  // Orb
+  if (running)
+  {
+    // Orb should not glow all the time: keep glow mostly tied to "hits".
+    const float glowAmt = 0.05f + 0.70f * hit + 0.20f * (leftPulse + rightPulse);
+
+    // Tail: starts at zero length and grows.
+    const float progress01 = barProgress01;
+    const float tailLength = 115.0f * progress01;
+    const float tailHeight = 5.6f + 3.2f * progress01;
+
+    const float tailStartX = juce::jmax(l.lineStartX, orbX - tailLength);
+    const float tailEndX = orbX - 8.0f;
+    if (quality.softGlow && tailEndX > tailStartX)
+    {
+      // Tapered streak (sharper, like the reference).
+      const float tailAmt = juce::jlimit(0.0f, 1.0f, 0.22f + 0.78f * progress01 + 0.22f * hit);
+      spriteAtlas->drawTail(g, tailStartX, tailEndX, orbY, tailHeight, tailAmt);
+    }
+
+    // Minimal orb halo only when needed.
+    if (quality.softGlow && glowAmt > 0.08f)
+      spriteAtlas->drawHalo(g, { orbX, orbY }, glowAmt);
+
+    spriteAtlas->drawOrb(g, { orbX, orbY }, glowAmt);
+  }
+}
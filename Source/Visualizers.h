@@ -0,0 +1,226 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "BeatModes.h"
+#include "FixedRingBuffer.h"
+#include "FrameProfiler.h"
+#include "QualityGovernor.h"
+#include "SharedAssetCache.h"
+#include "SpriteAtlas.h"
+#include "Theme.h"
+
+#include <memory>
+
+class TiledRenderer;
+
+//==============================================================================
+// Mode Visualizer - hosts one BeatModeRenderer and caches its static layer
+//==============================================================================
+class ModeVisualizer final : public juce::Component
+{
+public:
+  explicit ModeVisualizer(std::unique_ptr<BeatModeRenderer> modeRenderer);
+
+  void setColors(const ThemeColors& colors, juce::uint32 generation)
+  {
+    if (generation == themeGeneration)
+      return;
+
+    themeGeneration = generation;
+    theme = colors;
+    repaint();
+  }
+
+  // Advances the renderer to this frame; the static layer follows on the next paint if
+  // the meter changed.
+  void applyFrameState(const BeatFrameState& state);
+
+  // Modes are drawn at rest whenever the transport is stopped.
+  bool isAnimating() const { return frame.running || renderer->isAnimating(); }
+
+  void setProfiler(FrameProfiler* p) { profiler = p; }
+  void setQualityGovernor(QualityGovernor* g) { governor = g; }
+
+  const BeatModeRenderer& getRenderer() const noexcept { return *renderer; }
+
+  void paint(juce::Graphics& g) override;
+
+private:
+  void updateStaticLayer(float scale);
+  void paintFrame(juce::Graphics& g, float scale);
+
+  std::unique_ptr<BeatModeRenderer> renderer;
+  BeatFrameState frame;
+  ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
+  juce::uint32 themeGeneration = 0;
+  FrameProfiler* profiler = nullptr;
+  QualityGovernor* governor = nullptr;
+
+  juce::Image staticLayer;
+  LayerCacheKey staticLayerKey;
+  juce::Image lowResFrame;
+};
+
+//==============================================================================
+// Traffic Visualizer - horizontal beat timeline with marker interactions
+//==============================================================================
+class TrafficVisualizer final : public juce::Component
+{
+public:
+  void setBeatPhase(double phase) { beatPhase = phase; }
+  void setRunning(bool shouldRun) { running = shouldRun; }
+  void setBeatsPerBar(int beats)
+  {
+    const auto clamped = juce::jmax(1, beats);
+    if (clamped != beatsPerBar)
+    {
+      beatsPerBar = clamped;
+      repaint();
+    }
+  }
+
+  void setSubdivisions(int subs)
+  {
+    const auto clamped = juce::jmax(1, subs);
+    if (clamped != subdivisions)
+    {
+      subdivisions = clamped;
+      repaint();
+    }
+  }
+  void setCurrentBeat(int beat) { currentBeat = beat; }
+
+  // Each active lane gets its own marker row around the beat line.
+  void setPolyrhythmLanes(const PolyrhythmLanes& newLanes)
+  {
+    if (newLanes == lanes)
+      return;
+
+    lanes = newLanes;
+    ++lanesGeneration;
+    repaint();
+  }
+
+  // A bar index step is a bar wrap only while the discontinuity generation stays the same.
+  void setBarIndex(juce::int64 index) { barIndex = index; }
+  void setDiscontinuityGeneration(juce::uint32 generation) { discontinuityGeneration = generation; }
+  void setColors(const ThemeColors& colors, juce::uint32 generation)
+  {
+    if (generation == themeGeneration)
+      return;
+
+    themeGeneration = generation;
+    theme = colors;
+    repaint();
+  }
+
+  // Animation clock in seconds. The editor feeds its frame time; offscreen renders
+  // (benchmarks) feed a synthetic one so results don't depend on the wall clock.
+  void setFrameTime(double seconds) { frameTimeSeconds = seconds; }
+
+  // True while flash/ripple animations are still decaying after the transport stopped.
+  bool isAnimating() const { return leftFlash > 0.0f || !ripples.isEmpty(); }
+
+  void setProfiler(FrameProfiler* p) { profiler = p; }
+
+  // When set, large frames are rasterised in parallel horizontal bands.
+  void setTiledRenderer(TiledRenderer* renderer) { tiledRenderer = renderer; }
+
+  // Paint times are reported here; the settings it hands out arrive with each frame state.
+  void setQualityGovernor(QualityGovernor* g) { governor = g; }
+  void setQuality(const QualitySettings& newQuality) { quality = newQuality; }
+
+  // Advances the flash/ripple animation to the current frame time. Call once per frame
+  // after the setters; paint() only draws the resulting state.
+  void advanceAnimation();
+
+  // Applies a frame's inputs and advances the animation in one go.
+  void applyFrameState(const BeatFrameState& state);
+
+  void paint(juce::Graphics& g) override;
+
+private:
+  // Caps the per-frame ripple cost; a ripple lives ~0.28 s, so this covers any tempo/meter.
+  static constexpr size_t maxRipples = 16;
+
+  struct Ripple
+  {
+    int beatIndex = 0;
+    double birthTimeSeconds = 0.0;
+  };
+
+  struct Layout
+  {
+    float centreY = 0.0f;
+    float lineStartX = 0.0f;
+    float lineEndX = 0.0f;
+    float lineWidth = 0.0f;
+    float barWidth = 5.0f;
+    float barHeight = 120.0f;
+    float barY = 0.0f;
+  };
+
+  struct FlashOverlayKey
+  {
+    int width = 0;
+    int height = 0;
+    juce::uint64 colours = 0;
+
+    bool operator==(const FlashOverlayKey& other) const noexcept
+    {
+      return width == other.width && height == other.height && colours == other.colours;
+    }
+  };
+
+  using FlashOverlayCache = SharedAssetCache<FlashOverlayKey, juce::Image>;
+
+  static Layout getLayout(juce::Rectangle<float> bounds);
+  static float getLaneRowY(const Layout& l, int row);
+  float getBarProgress01() const;
+  void updateMarkerLayer(juce::Rectangle<float> bounds, float scale);
+  void updateFlashOverlay(int width, int height);
+
+  // Rebuilds any cached layer the next paint needs; paintLayers() then only reads state.
+  void prepareLayers(float scale);
+  void paintFrame(juce::Graphics& g, float scale);
+  void paintLayers(juce::Graphics& g) const;
+
+  double beatPhase = 0.0;
+  bool running = false;
+  int beatsPerBar = 4;
+  int subdivisions = 1;
+  int currentBeat = 0;
+  juce::int64 barIndex = 0;
+  juce::uint32 discontinuityGeneration = 0;
+  PolyrhythmLanes lanes;
+  juce::uint32 lanesGeneration = 0;
+  ThemeColors theme = getThemeColors(ColorTheme::HighContrast);
+  juce::uint32 themeGeneration = 0;
+  FrameProfiler* profiler = nullptr;
+  TiledRenderer* tiledRenderer = nullptr;
+  QualityGovernor* governor = nullptr;
+  QualitySettings quality;
+  juce::Image lowResFrame;
+
+  double frameTimeSeconds = 0.0;
+  double lastAdvanceTimeSeconds = -1.0;
+  float leftFlash = 0.0f;
+  juce::int64 lastBarIndex = 0;
+  bool lastBarIndexValid = false;
+  juce::uint32 lastDiscontinuityGeneration = 0;
+  float lastOrbMarkerSpace = -1.0f;
+
+  // The flash wash and sprites only depend on size/theme/scale, so they come from
+  // process-wide caches shared by every open editor.
+  juce::SharedResourcePointer<FlashOverlayCache> flashOverlayCache;
+  std::shared_ptr<const juce::Image> leftFlashOverlay;
+  FlashOverlayKey leftFlashOverlayKey;
+
+  juce::Image markerLayer;
+  LayerCacheKey markerLayerKey;
+
+  juce::SharedResourcePointer<OrbSpriteAtlasCache> spriteAtlasCache;
+  std::shared_ptr<const OrbSpriteAtlas> spriteAtlas;
+
+  FixedRingBuffer<Ripple, maxRipples> ripples;
+};